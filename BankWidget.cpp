@@ -1,4 +1,8 @@
 #include "BankWidget.h"
+#include "RomTools.h"
+#include "ByteOrderView.h"
+#include "MappedFile.h"
+#include "CompositionCache.h"
 #include <QPainter>
 #include <QPaintEvent>
 #include <QFileDialog>
@@ -6,10 +10,18 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMessageBox>
+#include <QShortcut>
 #include <QCryptographicHash>
 #include <QDir>
 #include <QFile>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <utility>
 
 MeterBar::MeterBar(QWidget* parent) : QWidget(parent) {
     setMinimumHeight(20);
@@ -75,31 +87,6 @@ void MeterBar::paintEvent(QPaintEvent*) {
         }
     }
 
-    }
-
-    // Middle marker at 256 KiB.
-    p.setPen(QPen(QColor("#111827"), 2));
-    p.drawLine(xMid, 0, xMid, H - 1);
-
-    // Visual mode hints:
-    // - <=256 KiB: mirrored area in upper half of bank is highlighted.
-    // - >256 KiB: overflow area (256..used) is hatched as warning.
-    if (consumed > 0 && consumed <= halfBytes) {
-        const int mirrorEnd = qBound(xMid, int((qint64(halfBytes + consumed) * W) / total), W);
-        const int mirrorW = qMax(0, mirrorEnd - xMid);
-        if (mirrorW > 0) {
-            QBrush mirrorBrush(QColor(59, 130, 246, 70), Qt::Dense6Pattern);
-            p.fillRect(QRect(xMid, 0, mirrorW, H), mirrorBrush);
-        }
-    } else if (consumed > halfBytes) {
-        const int overflowEnd = qBound(xMid, int((qint64(consumed) * W) / total), W);
-        const int overflowW = qMax(0, overflowEnd - xMid);
-        if (overflowW > 0) {
-            QBrush warnBrush(QColor(220, 38, 38, 90), Qt::BDiagPattern);
-            p.fillRect(QRect(xMid, 0, overflowW, H), warnBrush);
-        }
-    }
-
     p.setPen(Qt::black);
     p.drawRect(rect().adjusted(0, 0, -1, -1));
 }
@@ -122,10 +109,14 @@ BankWidget::BankWidget(int bankIndex, QWidget* parent)
     m_btnAdd    = new QPushButton("Add…", this);
     m_btnRemove = new QPushButton("Remove", this);   // kürzer
     m_btnClear  = new QPushButton("Clear", this);
+    m_btnUndo   = new QPushButton("Undo", this);
+    m_btnRedo   = new QPushButton("Redo", this);
     m_btnWrite  = new QPushButton("Write Slot", this);
     h->addWidget(m_btnAdd);
     h->addWidget(m_btnRemove);
     h->addWidget(m_btnClear);
+    h->addWidget(m_btnUndo);
+    h->addWidget(m_btnRedo);
     h->addStretch();
     h->addWidget(m_btnWrite);
     v->addLayout(h);
@@ -134,24 +125,46 @@ BankWidget::BankWidget(int bankIndex, QWidget* parent)
     connect(m_btnRemove, &QPushButton::clicked, this, &BankWidget::removeSelected);
     connect(m_btnClear,  &QPushButton::clicked, this, &BankWidget::clear);
     connect(m_btnWrite,  &QPushButton::clicked, this, &BankWidget::doWriteSlot);
+    connect(m_btnUndo,   &QPushButton::clicked, this, &BankWidget::undo);
+    connect(m_btnRedo,   &QPushButton::clicked, this, &BankWidget::redo);
+
+    // Ctrl+Z / Ctrl+Shift+Z act on the bank that has focus.
+    auto* undoKey = new QShortcut(QKeySequence::Undo, this);
+    undoKey->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(undoKey, &QShortcut::activated, this, &BankWidget::undo);
+    auto* redoKey = new QShortcut(QKeySequence::Redo, this);
+    redoKey->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(redoKey, &QShortcut::activated, this, &BankWidget::redo);
+
+    // Parts loaded from files follow their source: a save on disk reloads
+    // the part in the background and re-places only that part.
+    m_sourceWatcher = new QFileSystemWatcher(this);
+    connect(m_sourceWatcher, &QFileSystemWatcher::fileChanged, this, &BankWidget::onSourceChanged);
+    m_reloadTimer = new QTimer(this);
+    m_reloadTimer->setSingleShot(true);
+    m_reloadTimer->setInterval(300);   // toolchains write in several chunks
+    connect(m_reloadTimer, &QTimer::timeout, this, &BankWidget::startReloads);
+
+    m_preflightTimer = new QTimer(this);
+    m_preflightTimer->setSingleShot(true);
+    m_preflightTimer->setInterval(150);
+    connect(m_preflightTimer, &QTimer::timeout, this, &BankWidget::startPreflight);
+
+    m_preflightWatcher = new QFutureWatcher<Preflight>(this);
+    connect(m_preflightWatcher, &QFutureWatcher<Preflight>::finished,
+            this, &BankWidget::onPreflightFinished);
 
     refreshUi();
 }
 
 int BankWidget::usedBytes() const {
-    int sum = 0; for (auto& p : m_parts) sum += p.data.size(); return sum;
+    return payloadBytes(m_parts);
 }
 
-QByteArray BankWidget::swap16(const QByteArray& in) {
-    QByteArray out = in;
-    if (out.size() % 2) out.append(char(0xff));
-    for (int i = 0; i + 1 < out.size(); i += 2)
-        std::swap(out[i], out[i+1]);
-    return out;
+int BankWidget::payloadBytes(const QVector<RomPart>& parts) {
+    int sum = 0; for (auto& p : parts) sum += p.data.size(); return sum;
 }
 
-
-
 bool BankWidget::shouldAutoSwap(const QFileInfo& fi) {
     const QString ext = fi.suffix().toLower();
 
@@ -160,35 +173,6 @@ bool BankWidget::shouldAutoSwap(const QFileInfo& fi) {
     return (ext == "rom");
 }
 
-/* ---------------------------------------------------------------------------
-   hasCanonicalSignatures – heuristic: does `data` look like canonical
-   big-endian Amiga ROM content?  Checks for RomTag magic (0x4AFC) and
-   Kickstart header patterns at plausible positions.
-   ----------------------------------------------------------------------- */
-bool BankWidget::hasCanonicalSignatures(const QByteArray& data) {
-    if (data.size() < 2) return false;
-
-    // Check first word for RomTag magic.
-    if (readBe16(data, 0) == 0x4AFC) return true;
-
-    // Kickstart header: 0x1111 0x4EF9  or  0x4EF9 at word 0.
-    if (data.size() >= 4) {
-        const quint16 w0 = readBe16(data, 0);
-        const quint16 w1 = readBe16(data, 2);
-        if (w0 == 0x1111 && w1 == 0x4EF9) return true;
-        if (w0 == 0x4EF9) return true;
-    }
-
-    // Scan first 256 bytes for RomTag (some components have a small preamble).
-    for (int off = 2; off + 2 <= qMin(data.size(), 256); off += 2) {
-        if (readBe16(data, off) == 0x4AFC) return true;
-    }
-
-    // Deterministic policy: .rom is swapped, .bin is canonical and stays unchanged.
-    if (ext == "rom") return true;
-    return false;
-}
-
 quint32 BankWidget::readBe32(const QByteArray& in, int off) {
     if (off < 0 || off + 4 > in.size()) return 0;
     const auto* p = reinterpret_cast<const unsigned char*>(in.constData() + off);
@@ -201,14 +185,6 @@ quint16 BankWidget::readBe16(const QByteArray& in, int off) {
     return (quint16(p[0]) << 8) | quint16(p[1]);
 }
 
-void BankWidget::writeBe32(QByteArray& out, int off, quint32 v) {
-    if (off < 0 || off + 4 > out.size()) return;
-    out[off + 0] = char((v >> 24) & 0xff);
-    out[off + 1] = char((v >> 16) & 0xff);
-    out[off + 2] = char((v >> 8) & 0xff);
-    out[off + 3] = char(v & 0xff);
-}
-
 bool BankWidget::looksLikeKickstartHeader(const QByteArray& image, int effectiveSize) {
     if (effectiveSize < 0x20 || image.size() < effectiveSize) return false;
 
@@ -224,20 +200,21 @@ bool BankWidget::looksLikeKickstartHeader(const QByteArray& image, int effective
     return hasJump || plausibleVersion;
 }
 
-QStringList BankWidget::validateRomTags(const QByteArray& image, int effectiveSize) {
+QStringList BankWidget::validateRomTags(const RomTagIndex& tags, int effectiveSize) {
     QStringList issues;
-    if (effectiveSize <= 0 || image.size() < effectiveSize) return issues;
+    if (effectiveSize <= 0) return issues;
 
     const quint32 baseAddr = 0x01000000u - quint32(effectiveSize);
     const quint32 endAddr = baseAddr + quint32(effectiveSize);
 
     int checked = 0;
-    for (int off = 0; off + 26 <= effectiveSize; ++off) {
-        if (readBe16(image, off) != 0x4AFC) continue;
+    for (int t = 0; t < tags.size(); ++t) {
+        const int off = tags.offset[t];
+        if (off + RomTagIndex::RESIDENT_SIZE > effectiveSize) break;
 
-        const quint32 matchTag = readBe32(image, off + 2) & 0x00FFFFFFu;
-        const quint32 endSkip = readBe32(image, off + 6) & 0x00FFFFFFu;
-        const quint32 namePtr = readBe32(image, off + 14) & 0x00FFFFFFu;
+        const quint32 matchTag = tags.matchTag[t];
+        const quint32 endSkip = tags.endSkip[t];
+        const quint32 namePtr = tags.name[t];
 
         const quint32 selfAddr = baseAddr + quint32(off);
         if (matchTag != selfAddr) {
@@ -271,36 +248,17 @@ QStringList BankWidget::validateRomTags(const QByteArray& image, int effectiveSi
     return issues;
 }
 
-void BankWidget::finalizeKickstartChecksum(QByteArray& image, int effectiveSize) {
-    if (effectiveSize <= 0 || effectiveSize > image.size() || (effectiveSize % 4) != 0) return;
-
-    // Amiga Kickstart checksum: the carry-propagating (ones' complement)
-    // sum of all 32-bit big-endian longwords must equal 0xFFFFFFFF.
-    // This matches exec.library's SumKickData() which uses:
-    //   add.l (a0)+,d0 / bcc.s .noc / addq.l #1,d0
-    const int checksumOff = effectiveSize - 4;
-    writeBe32(image, checksumOff, 0);
-
-    quint32 sum = 0;
-    for (int off = 0; off < effectiveSize; off += 4) {
-        quint32 old = sum;
-        sum += readBe32(image, off);
-        if (sum < old) ++sum;           // fold carry (ones' complement add)
-    }
-    const quint32 checksum = ~sum;
-    writeBe32(image, checksumOff, checksum);
-}
-
 /* ---------------------------------------------------------------------------
    detectOriginalAddr – determine the original ROM address of a component.
 
    For __rom_header parts the address equals the ROM base (detected later).
    For normal components the first bytes are the RomTag (0x4AFC magic),
-   and rt_MatchTag (bytes 2-5) encodes the original absolute address.
+   and rt_MatchTag (bytes 2-5) encodes the original absolute address; it is
+   taken from the part's RomTagIndex instead of re-reading the bytes.
    Returns 0 for __rom_header parts (always placed at ROM base),
    or the 24-bit rt_MatchTag value for regular components.
    ----------------------------------------------------------------------- */
-quint32 BankWidget::detectOriginalAddr(const QByteArray& data, const QString& name) {
+quint32 BankWidget::detectOriginalAddr(const RomTagIndex& tags, const QString& name) {
     // __rom_header is always placed at offset 0 (= baseAddr).
     if (name.contains("__rom_header", Qt::CaseInsensitive))
         return 0;
@@ -312,40 +270,17 @@ quint32 BankWidget::detectOriginalAddr(const QByteArray& data, const QString& na
         return addr >= 0x00800000u && addr < 0x01000000u;
     };
 
-    // Regular component: RomTag should be at the very start.
-    if (data.size() >= 6 && readBe16(data, 0) == 0x4AFC) {
-        quint32 matchTag = readBe32(data, 2) & 0x00FFFFFFu;
-        if (plausibleRomAddr(matchTag))
-            return matchTag;
-    }
-
-    // Fallback: scan first 64 bytes for a RomTag.
-    for (int off = 2; off + 6 <= qMin(data.size(), 64); off += 2) {
-        if (readBe16(data, off) != 0x4AFC) continue;
-        quint32 matchTag = readBe32(data, off + 2) & 0x00FFFFFFu;
-        if (plausibleRomAddr(matchTag))
-            return matchTag;
+    // Regular component: RomTag should be at the very start; otherwise take
+    // the first word-aligned RomTag within the first 64 bytes.
+    for (int t = 0; t < tags.size() && tags.offset[t] + 6 <= 64; ++t) {
+        if (tags.offset[t] & 1) continue;
+        if (plausibleRomAddr(tags.matchTag[t]))
+            return tags.matchTag[t];
     }
 
     return 0;   // unknown – will trigger concatenation fallback
 }
 
-/* ---------------------------------------------------------------------------
-   verifyKickstartChecksum – re-compute the ones' complement sum over the
-   given effective range and return true iff it equals 0xFFFFFFFF.
-   ----------------------------------------------------------------------- */
-bool BankWidget::verifyKickstartChecksum(const QByteArray& image, int effectiveSize) {
-    if (effectiveSize <= 0 || effectiveSize > image.size() || (effectiveSize % 4) != 0)
-        return false;
-    quint32 sum = 0;
-    for (int off = 0; off < effectiveSize; off += 4) {
-        quint32 old = sum;
-        sum += readBe32(image, off);
-        if (sum < old) ++sum;
-    }
-    return (sum == 0xFFFFFFFFu);
-}
-
 /* ---------------------------------------------------------------------------
    relocateRomTags – patch absolute addresses inside Resident (RomTag)
    structures so that a bank composed from individually extracted components
@@ -366,26 +301,67 @@ bool BankWidget::verifyKickstartChecksum(const QByteArray& image, int effectiveS
      3. Absolute function-table entries (if the table is not in relative mode)
      4. Reset vector (Initial PC at offset +4) when the effective base changes
 
-   Returns the number of RomTags that were patched (0 when the image was
-   already consistent).
+   Works in place on `size` bytes at `data` (a bank window).  Returns the
+   number of RomTags that were patched (0 when the image was already
+   consistent).  If `rawSum` is given it is kept equal to the raw longword
+   sum of the image across all patches.
+
+   Incremental use: with `ranges` only RomTags whose magic lies in one of
+   the [from, to) ranges (the parts that moved) are considered; `writes`
+   receives (RomTag offset, patched offset) for every longword written,
+   -1 as RomTag offset for the reset vector.
    ----------------------------------------------------------------------- */
-int BankWidget::relocateRomTags(QByteArray& image, int effectiveSize) {
-    if (effectiveSize <= 0 || image.size() < effectiveSize) return 0;
+int BankWidget::relocateRomTags(char* data, int size, int effectiveSize, RomTagIndex& tags, quint64* rawSum,
+                                const QVector<QPair<int, int>>* ranges,
+                                QVector<QPair<int, int>>* writes) {
+    if (!data || effectiveSize <= 0 || size < effectiveSize) return 0;
     if ((effectiveSize % 2) != 0) return 0;
 
     const quint32 baseAddr = 0x01000000u - quint32(effectiveSize);
     const quint32 endAddr  = baseAddr + quint32(effectiveSize);
 
+    // Read-only view for the decoders; all writes go through patch32 → data.
+    const QByteArray image = QByteArray::fromRawData(data, size);
+
+    // Every patch also moves a caller-maintained raw checksum sum, so the
+    // checksum can be finalized without another pass over the image.
+    int writer = -1;   // RomTag being patched, -1 = reset vector
+    auto patch32 = [&](int at, quint32 v) {
+        if (writes) writes->push_back(qMakePair(writer, at));
+        const bool inSum = rawSum && at >= 0 && at + 4 <= effectiveSize;
+        if (at < 0 || at + 4 > size) return;
+        if (inSum) *rawSum -= RomKernels::placedSum(RomKernels::laneSums(data + at, 4), at);
+        data[at + 0] = char((v >> 24) & 0xff);
+        data[at + 1] = char((v >> 16) & 0xff);
+        data[at + 2] = char((v >> 8) & 0xff);
+        data[at + 3] = char(v & 0xff);
+        if (inSum) *rawSum += RomKernels::placedSum(RomKernels::laneSums(data + at, 4), at);
+    };
+
     int patched = 0;
 
-    for (int off = 0; off + 26 <= effectiveSize; off += 2) {
-        if (readBe16(image, off) != 0x4AFC) continue;
+    // RomTags come pre-decoded from the index (exec only looks at even
+    // addresses).  Patches may rewrite bytes behind a hit, so re-check the
+    // magic against the live image and honour the skip past every handled
+    // RomTag like exec does.  Patched entries are re-read into the index.
+    int resumeAt = 0;
+    int range = 0;
+    for (int t = 0; t < tags.size(); ++t) {
+        const int off = tags.offset[t];
+        if (off + RomTagIndex::RESIDENT_SIZE > effectiveSize) break;
+        if (ranges) {
+            while (range < ranges->size() && off >= ranges->at(range).second) ++range;
+            if (range >= ranges->size()) break;
+            if (off < ranges->at(range).first) continue;
+        }
+        if ((off & 1) || off < resumeAt || readBe16(image, off) != 0x4AFC) continue;
+        writer = off;
 
-        const quint32 matchTag = readBe32(image, off + 2) & 0x00FFFFFFu;
+        const quint32 matchTag = tags.matchTag[t];
         const quint32 selfAddr = baseAddr + quint32(off);
 
         if (matchTag == selfAddr) {          // already in place
-            off += 24;                       // skip past this RomTag structure
+            resumeAt = off + 26;             // skip past this RomTag structure
             continue;
         }
 
@@ -395,7 +371,7 @@ int BankWidget::relocateRomTags(QByteArray& image, int effectiveSize) {
         const qint64 delta = qint64(selfAddr) - qint64(matchTag);
 
         // Plausibility gate: after relocation rt_Name must point to printable ASCII.
-        const quint32 namePtr = readBe32(image, off + 14) & 0x00FFFFFFu;
+        const quint32 namePtr = tags.name[t];
         if (namePtr != 0) {
             quint32 newName = quint32(qint64(namePtr) + delta);
             if (newName < baseAddr || newName >= endAddr) continue;
@@ -406,67 +382,84 @@ int BankWidget::relocateRomTags(QByteArray& image, int effectiveSize) {
         // ---- patch RomTag fields ----
 
         // rt_MatchTag (+2) – self-pointer
-        writeBe32(image, off + 2, selfAddr);
+        patch32(off + 2, selfAddr);
 
         // rt_EndSkip (+6) – scanner resume address; clamp into [self+26 .. endAddr]
         {
-            quint32 es = readBe32(image, off + 6) & 0x00FFFFFFu;
+            quint32 es = tags.endSkip[t];
             if (es != 0) {
                 quint32 newEs = quint32(qint64(es) + delta);
                 if (newEs > endAddr) newEs = endAddr;
                 if (newEs <= selfAddr) newEs = selfAddr + 26;
-                writeBe32(image, off + 6, newEs);
+                patch32(off + 6, newEs);
             }
         }
 
         // rt_Name (+14)
         if (namePtr != 0)
-            writeBe32(image, off + 14, quint32(qint64(namePtr) + delta));
+            patch32(off + 14, quint32(qint64(namePtr) + delta));
 
         // rt_IdString (+18)
         {
-            quint32 ids = readBe32(image, off + 18) & 0x00FFFFFFu;
+            quint32 ids = tags.idString[t];
             if (ids != 0) {
                 quint32 newIds = quint32(qint64(ids) + delta);
                 if (newIds >= baseAddr && newIds < endAddr)
-                    writeBe32(image, off + 18, newIds);
+                    patch32(off + 18, newIds);
             }
         }
 
         // rt_Init (+22) – init function or AUTOINIT table pointer
         quint32 newInitAddr = 0;
         {
-            quint32 initVal = readBe32(image, off + 22) & 0x00FFFFFFu;
+            quint32 initVal = tags.init[t];
             if (initVal != 0) {
                 newInitAddr = quint32(qint64(initVal) + delta);
                 if (newInitAddr >= baseAddr && newInitAddr < endAddr)
-                    writeBe32(image, off + 22, newInitAddr);
+                    patch32(off + 22, newInitAddr);
                 else
                     newInitAddr = 0;
             }
         }
 
         // ---- RTF_AUTOINIT: patch the init-struct pointed to by rt_Init ----
-        const quint8 flags = static_cast<quint8>(image.at(off + 10));
-        if ((flags & 0x80) && newInitAddr != 0) {
+        if ((tags.flags[t] & 0x80) && newInitAddr != 0) {
             const int iso = int(newInitAddr - baseAddr);   // image offset of init struct
             if (iso >= 0 && iso + 16 <= effectiveSize) {
                 // struct layout:  +0 dataSize | +4 funcTable | +8 dataInit | +12 initFunc
+                // The index already holds the pointers when it located the
+                // same struct; a struct outside the tag's part is read live.
+                const bool indexed = (tags.initStruct[t] == iso);
                 quint32 newFuncTab = 0;
                 const int fields[] = { 4, 8, 12 };
                 for (int f : fields) {
-                    quint32 ptr = readBe32(image, iso + f) & 0x00FFFFFFu;
+                    quint32 ptr;
+                    if (indexed)
+                        ptr = (f == 4) ? tags.funcTable[t] : (f == 8) ? tags.dataInit[t] : tags.initFunc[t];
+                    else
+                        ptr = readBe32(image, iso + f) & 0x00FFFFFFu;
                     if (ptr == 0) continue;
                     quint32 np = quint32(qint64(ptr) + delta);
                     if (np >= baseAddr && np < endAddr) {
-                        writeBe32(image, iso + f, np);
+                        patch32(iso + f, np);
                         if (f == 4) newFuncTab = np;
                     }
                 }
 
                 // If funcTable uses absolute pointers (first word != 0xFFFF),
                 // patch every 32-bit entry until the 0xFFFFFFFF terminator.
-                if (newFuncTab != 0) {
+                // The index (or the catalog behind it) may already know
+                // which entries those are.
+                const int ftKnown = int(newFuncTab - baseAddr);
+                if (newFuncTab != 0 && indexed && !tags.funcEntries[t].isEmpty()
+                    && tags.funcEntries[t].first() >= ftKnown) {
+                    for (const int e : tags.funcEntries[t]) {
+                        if (e + 4 > effectiveSize) break;
+                        const quint32 ne = quint32(qint64(readBe32(image, e) & 0x00FFFFFFu) + delta);
+                        if (ne >= baseAddr && ne < endAddr)
+                            patch32(e, ne);
+                    }
+                } else if (newFuncTab != 0) {
                     int ftOff = int(newFuncTab - baseAddr);
                     if (ftOff >= 0 && ftOff + 2 <= effectiveSize &&
                         readBe16(image, ftOff) != 0xFFFF)
@@ -479,18 +472,20 @@ int BankWidget::relocateRomTags(QByteArray& image, int effectiveSize) {
                             if (e24 < 0x00F80000u) continue;   // not a ROM pointer
                             quint32 ne = quint32(qint64(e24) + delta);
                             if (ne >= baseAddr && ne < endAddr)
-                                writeBe32(image, e, ne);
+                                patch32(e, ne);
                         }
                     }
                 }
             }
         }
 
+        tags.refresh(image, t);
         ++patched;
-        off += 24;   // skip rest of RomTag; loop adds +2 → next check at off+26
+        resumeAt = off + 26;   // skip rest of RomTag
     }
 
     // ---- Patch reset vector (Initial PC at offset +4) when base changed ----
+    writer = -1;
     if (patched > 0 && image.size() >= 8) {
         const quint32 pc = readBe32(image, 4) & 0x00FFFFFFu;
         if (pc >= 0x00F80000u && (pc < baseAddr || pc >= endAddr)) {
@@ -500,7 +495,7 @@ int BankWidget::relocateRomTags(QByteArray& image, int effectiveSize) {
                 if (pc >= tryBase && pc < tryBase + sz) {
                     quint32 newPc = baseAddr + (pc - tryBase);
                     if (newPc >= baseAddr && newPc < endAddr)
-                        writeBe32(image, 4, newPc);
+                        patch32(4, newPc);
                     break;
                 }
             }
@@ -510,176 +505,420 @@ int BankWidget::relocateRomTags(QByteArray& image, int effectiveSize) {
     return patched;
 }
 
-    // Henne-Ei safe: checksum slot is treated as 0 during summation,
-    // then filled with the additive inverse so global sum becomes 0xFFFFFFFF.
-    const int checksumOff = effectiveSize - 4;
-    writeBe32(image, checksumOff, 0);
+QByteArray BankWidget::buildTiled512k() const {
+    return composition().image;
+}
 
-    quint64 sum = 0;
-    for (int off = 0; off < effectiveSize; off += 4) {
-        sum += readBe32(image, off);
+/* ---------------------------------------------------------------------------
+   composition – the composed bank, built at most once per generation.
+   Every change to m_parts goes through markDirty(); validators, save and
+   write all read this one cached result, which the background preflight
+   usually has filled in already.
+   ----------------------------------------------------------------------- */
+const BankWidget::Composition& BankWidget::composition() const {
+    if (m_composedGeneration != m_generation) {
+        const Placements previous = m_composed.placements;
+        m_composed = runPreflight(m_parts, previous, m_generation).comp;
+        m_composedGeneration = m_generation;
     }
-    const quint32 partial = quint32(sum & 0xFFFFFFFFu);
-    const quint32 checksum = quint32((0x100000000ULL - partial) & 0xFFFFFFFFu);
-    writeBe32(image, checksumOff, checksum);
+    return m_composed;
 }
 
-QByteArray BankWidget::buildTiled512k() const {
-    if (m_parts.isEmpty()) {
-        return QByteArray(SLOT_SIZE, char(0xff));
+/* ---------------------------------------------------------------------------
+   poolBlob – the pooled blob of a part file's bytes in canonical order.
+   `canonical` must own its bytes (never a mapped view): exactly the buffer
+   that is hashed is what the pool keeps, so a file rewritten meanwhile
+   cannot put other bytes under this digest.  Content-addressed: bytes
+   loaded anywhere already (another bank, the same catalog again) share
+   that blob and its analysis.  Safe on worker threads.
+   ----------------------------------------------------------------------- */
+PartBlobPtr BankWidget::poolBlob(const QString& path, const QByteArray& canonical, bool swapped, bool* known) {
+    const QByteArray sha = QCryptographicHash::hash(canonical, QCryptographicHash::Sha256);
+    if (known) *known = PartPool::instance().find(sha) != nullptr;
+    return PartPool::instance().acquire(
+        sha,
+        [&] { return canonical; },
+        [&](PartBlob& b) {
+            // Components from an extraction carry their relocation sites
+            // in the catalog; only loose files get scanned.
+            const bool fromCatalog = !swapped && RomTools::catalogRomTags(path, b.data, b.sha256, &b.tags);
+            if (!fromCatalog) b.tags = RomTagIndex::build(b.data);
+            b.romTagAddr = detectOriginalAddr(b.tags, QString());
+        });
+}
+
+RomPart BankWidget::makePart(const PartBlobPtr& blob, const QString& name, bool swapped) {
+    RomPart part;
+    part.id       = nextPartId();
+    part.name     = name;
+    part.blob     = blob;
+    part.data     = blob->data;
+    part.sha256   = blob->sha256;
+    part.swapped  = swapped;
+    part.laneSums = blob->laneSums;
+    part.tags     = blob->tags;
+    // __rom_header is always placed at offset 0 (= baseAddr).
+    part.originalAddr = name.contains("__rom_header", Qt::CaseInsensitive) ? 0 : blob->romTagAddr;
+    return part;
+}
+
+quint64 BankWidget::nextPartId() {
+    static std::atomic<quint64> counter{0};
+    return ++counter;
+}
+
+void BankWidget::markDirty() {
+    ++m_generation;
+}
+
+BankWidget::Composition BankWidget::composeBank(const QVector<RomPart>& parts, const Placements& previous) {
+    QByteArray image(SLOT_SIZE, Qt::Uninitialized);
+    Composition comp = composeInto(parts, image.data(), previous);
+    comp.image = std::move(image);
+    return comp;
+}
+
+/* ---------------------------------------------------------------------------
+   composeInto – compose `parts` straight into a SLOT_SIZE window (e.g. one
+   bank of a 2 MiB buffer).  Every byte of the window is written (effective
+   image, then the mirror for 256 KiB); the result carries the tag index and
+   effective size, not the bytes.
+   ----------------------------------------------------------------------- */
+BankWidget::Composition BankWidget::composeInto(const QVector<RomPart>& parts, char* window,
+                                                const Placements& previous) {
+    Composition comp;
+    if (parts.isEmpty()) {
+        std::memset(window, 0xff, SLOT_SIZE);
+        return comp;
     }
 
     static const int HALF_BANK = SLOT_SIZE / 2; // 256 KiB
 
+    // Read-only view of the window for the decoders; writes use `window`.
+    const QByteArray view = QByteArray::fromRawData(window, SLOT_SIZE);
+
+    // A RomTag can straddle two parts; the part indexes only hold complete
+    // structures, so the last bytes of every part are decoded from the image.
+    auto indexPart = [&](const RomTagIndex& partTags, int partSize, int destOff, int limit) {
+        comp.tags.append(partTags, destOff, limit);
+        const int end = qMin(destOff + partSize, limit);
+        comp.tags.addRange(QByteArray::fromRawData(window, limit),
+                           end - (RomTagIndex::RESIDENT_SIZE - 1), end);
+    };
+    // <= 256 KiB effective: one copy of the lower half into the upper half.
+    auto mirrorIfHalf = [&]() {
+        if (comp.effectiveSize != HALF_BANK) return;
+        std::memcpy(window + HALF_BANK, window, HALF_BANK);
+        const RomTagIndex lower = comp.tags;
+        comp.tags.append(lower, HALF_BANK, SLOT_SIZE);
+    };
+
     /* ------------------------------------------------------------------
-       Gap-filling strategy: if ALL loaded parts have a known original
-       ROM address (from their RomTag's rt_MatchTag), place each one at
-       its ORIGINAL offset inside the image.  Gaps left by omitted
-       components are filled with 0xFF.  This preserves every absolute
-       address in the 68000 machine code and is the only way to safely
-       drop individual modules from a Kickstart ROM.
+       Gap-filling strategy: parts with a known original ROM address (from
+       their RomTag's rt_MatchTag) are placed at their ORIGINAL offset
+       inside the image.  Gaps left by omitted components are filled with
+       0xFF.  This preserves every absolute address in the 68000 machine
+       code and is the only way to safely drop individual modules from a
+       Kickstart ROM.
+
+       The layout is an interval map (RomLayout): pinning a part reports
+       its collisions with earlier parts right away.  Parts without a known
+       address go into the free gaps, largest first, each into the gap that
+       fits it best, and are relocated there.
+
+       The checksum is never re-summed over the image: every part carries
+       its lane sums, so the raw longword sum of the composition follows
+       from the part placements and the 0xFF fill in O(parts).
        ------------------------------------------------------------------ */
-    bool canGapFill = (m_parts.size() > 1);   // single-part = monolithic, no gap-fill needed
-    bool hasHeader = false;
+    bool canGapFill = (parts.size() > 1);   // single-part = monolithic, no gap-fill needed
+    bool anyKnown = false;
     quint32 addrMin = 0x01000000u;
     quint32 addrMax = 0;
 
     if (canGapFill) {
-        for (const auto& p : m_parts) {
+        for (const auto& p : parts) {
             if (p.name.contains("__rom_header", Qt::CaseInsensitive)) {
-                hasHeader = true;
                 continue;   // header is always at offset 0
             }
-            if (p.originalAddr == 0) {
-                canGapFill = false;     // unknown address → fall back
-                break;
-            }
+            if (p.originalAddr == 0) continue;   // placed into a gap later
+            anyKnown = true;
             if (p.originalAddr < addrMin) addrMin = p.originalAddr;
             quint32 end = p.originalAddr + quint32(p.data.size());
             if (end > addrMax) addrMax = end;
         }
+        // Nothing to anchor the layout → concatenation.
+        canGapFill = anyKnown;
     }
 
     if (canGapFill && addrMin >= 0x00800000u && addrMax <= 0x01000000u) {
-        // Determine original ROM size from the address range spanned.
-        // baseAddr = 0x01000000 - effectiveSize; pick the smallest
-        // power-of-two effectiveSize (256K or 512K) whose base ≤ addrMin.
-        int effectiveSize = HALF_BANK;  // try 256 KiB first
-        quint32 baseAddr = 0x01000000u - quint32(effectiveSize);
-        if (addrMin < baseAddr) {
-            effectiveSize = SLOT_SIZE;  // need 512 KiB
-            baseAddr = 0x01000000u - quint32(effectiveSize);
-        }
-
-        if (addrMin >= baseAddr) {      // addresses fit
-            QByteArray image(effectiveSize, char(0xff));
-
-            // Place each part at its original ROM offset.
-            for (const auto& p : m_parts) {
+        // Determine original ROM size from the address range spanned:
+        // baseAddr = 0x01000000 - effectiveSize; take the smaller size
+        // (256K before 512K) whose base ≤ addrMin and whose gaps hold the
+        // parts without an address.
+        const int sizes[] = { HALF_BANK, SLOT_SIZE };
+        for (const int effectiveSize : sizes) {
+            const quint32 baseAddr = 0x01000000u - quint32(effectiveSize);
+            if (addrMin < baseAddr) continue;
+
+            RomLayout layout(effectiveSize);
+            QVector<int> offsets(parts.size(), -1);
+            QVector<int> unknown;
+            for (int i = 0; i < parts.size(); ++i) {
+                const auto& p = parts[i];
+                const int size = int(p.data.size());
                 int destOff;
                 if (p.name.contains("__rom_header", Qt::CaseInsensitive)) {
                     destOff = 0;
+                } else if (p.originalAddr == 0) {
+                    unknown.push_back(i);
+                    continue;
                 } else {
                     destOff = int(p.originalAddr - baseAddr);
                 }
-                if (destOff < 0 || destOff + p.data.size() > effectiveSize) continue;
-                memcpy(image.data() + destOff, p.data.constData(), p.data.size());
+                if (layout.reserve(i, destOff, size)) offsets[i] = destOff;
+            }
+
+            // Best-fit decreasing: big parts pick their gap first; equal
+            // sizes keep their list order, so the layout is reproducible.
+            std::stable_sort(unknown.begin(), unknown.end(), [&](int a, int b) {
+                return parts[a].data.size() > parts[b].data.size();
+            });
+            bool fits = true;
+            for (const int i : unknown) {
+                offsets[i] = layout.place(i, int(parts[i].data.size()));
+                if (offsets[i] < 0) { fits = false; break; }
+            }
+            if (!fits) continue;   // try the larger layout / concatenation
+
+            comp.effectiveSize = effectiveSize;
+            comp.gapFilled = true;
+            comp.offsets = offsets;
+            comp.overlaps = layout.overlaps();
+            std::memset(window, 0xff, effectiveSize);
+            quint64 rawSum = RomKernels::fillSum(0, effectiveSize, 0xff);
+            QVector<QPair<int, int>> placed;   // (destOff, part index)
+            placed.reserve(parts.size());
+
+            // Copy in list order: where parts overlap the later one wins.
+            for (int i = 0; i < parts.size(); ++i) {
+                const auto& p = parts[i];
+                if (offsets[i] < 0) continue;
+                std::memcpy(window + offsets[i], p.data.constData(), p.data.size());
+                rawSum += RomKernels::placedSum(p.laneSums, offsets[i])
+                        - RomKernels::fillSum(offsets[i], p.data.size(), 0xff);
+                placed.push_back(qMakePair(offsets[i], i));
+            }
+            std::sort(placed.begin(), placed.end());
+
+            // Overlapping parts overwrite each other, which neither the
+            // per-part sums nor the per-part tag indexes can express → fall
+            // back to a full pass over the image in that case only.
+            const bool overlap = !comp.overlaps.isEmpty();
+            if (overlap) {
+                comp.tags = RomTagIndex::build(QByteArray::fromRawData(window, effectiveSize));
+            } else {
+                for (const auto& pl : placed) {
+                    const auto& p = parts[pl.second];
+                    indexPart(p.tags, int(p.data.size()), pl.first, effectiveSize);
+                }
             }
 
-            if (looksLikeKickstartHeader(image, effectiveSize)) {
-                finalizeKickstartChecksum(image, effectiveSize);
+            // Only the gap-placed parts moved away from their RomTags.
+            QVector<QPair<int, int>> moved;
+            for (const auto& pl : placed) {
+                if (std::find(unknown.begin(), unknown.end(), pl.second) != unknown.end())
+                    moved.push_back(qMakePair(pl.first, pl.first + int(parts[pl.second].data.size())));
             }
+            if (!moved.isEmpty())
+                relocateRomTags(window, effectiveSize, effectiveSize, comp.tags, &rawSum, &moved);
 
-            // If 256 KiB effective: mirror to fill 512 KiB bank.
-            if (effectiveSize == HALF_BANK) {
-                QByteArray out;
-                out.reserve(SLOT_SIZE);
-                out.append(image);
-                out.append(image);
-                return out;
+            if (looksLikeKickstartHeader(view, effectiveSize)) {
+                if (overlap)
+                    RomTools::finalizeKickChecksum(window, effectiveSize);
+                else
+                    RomTools::finalizeKickChecksumFromSum(window, effectiveSize, rawSum);
             }
-            return image;
+
+            // If 256 KiB effective: mirror to fill 512 KiB bank.
+            mirrorIfHalf();
+            return comp;
         }
-        // else: addresses don't fit in 512 KiB → fall through to concatenation
+        // else: parts don't fit in 512 KiB → fall through to concatenation
     }
 
     /* ------------------------------------------------------------------
        Fallback: simple concatenation (for monolithic parts, non-component
        binaries, or parts without detectable original addresses).
-       Applies RomTag relocation as a best-effort fixup.
+       Applies RomTag relocation as a best-effort fixup; the relocator
+       keeps the raw checksum sum in step with every longword it patches.
+
+       Relocation is incremental: a part found in `previous` at the same
+       offset and effective size is placed as it came out of relocation
+       last time, and only the RomTags of parts that moved are patched.
        ------------------------------------------------------------------ */
-    QByteArray base;
-    base.reserve(SLOT_SIZE);
-    for (const auto& p : m_parts) base.append(p.data);
-
-    if (base.size() <= HALF_BANK) {
-        QByteArray half = base.left(HALF_BANK);
-        if (half.size() < HALF_BANK) {
-            half.append(QByteArray(HALF_BANK - half.size(), char(0xff)));
+    // <= 256 KiB payloads become a 256 KiB image mirrored to 512 KiB, which
+    // keeps classic 256 KiB ROM layout compatible in a 512 KiB bank.
+    // > 256 KiB payloads keep a linear layout padded up to the full bank.
+    const int payload = payloadBytes(parts);
+    const int effectiveSize = (payload <= HALF_BANK) ? HALF_BANK : SLOT_SIZE;
+    const bool sumsValid = (payload <= effectiveSize);
+    comp.effectiveSize = effectiveSize;
+
+    // Parts go straight into the window; whatever exceeds the effective
+    // size is cut off, the rest of it is 0xFF.
+    QVector<int> starts;                    // image offset of every placed part
+    QVector<QPair<int, int>> moved;         // [from, to) of parts to relocate
+    QVector<int> movedParts;
+    starts.reserve(parts.size());
+    int offset = 0;
+    quint64 rawSum = 0;
+    for (int i = 0; i < parts.size(); ++i) {
+        const auto& p = parts[i];
+        const int size = int(p.data.size());
+        const int n = qMin(size, effectiveSize - offset);
+        if (n <= 0) break;
+        starts.push_back(offset);
+
+        const auto prev = previous.constFind(p.id);
+        const bool reuse = n == size && prev != previous.constEnd()
+                        && prev->offset == offset && prev->effectiveSize == effectiveSize;
+        if (reuse && !prev->bytes.isNull()) {
+            std::memcpy(window + offset, prev->bytes.constData(), n);
+            rawSum += RomKernels::placedSum(prev->laneSums, offset);
+            indexPart(prev->tags, size, offset, effectiveSize);
+        } else {
+            std::memcpy(window + offset, p.data.constData(), n);
+            rawSum += RomKernels::placedSum(p.laneSums, offset);
+            indexPart(p.tags, size, offset, effectiveSize);
         }
-        relocateRomTags(half, HALF_BANK);
-        if (looksLikeKickstartHeader(half, HALF_BANK)) {
-            finalizeKickstartChecksum(half, HALF_BANK);
+        if (!reuse) {
+            moved.push_back(qMakePair(offset, offset + n));
+            movedParts.push_back(i);
         }
-
-
-    if (base.isEmpty()) {
-        return QByteArray(SLOT_SIZE, char(0xff));
+        offset += n;
     }
-
-    static const int HALF_BANK = SLOT_SIZE / 2; // 256 KiB
-
-    // For <= 256 KiB payloads, build a 256 KiB image and mirror it to 512 KiB.
-    // This keeps classic 256 KiB ROM layout compatible in a 512 KiB bank.
-    if (base.size() <= HALF_BANK) {
-        QByteArray half = base.left(HALF_BANK);
-        if (half.size() < HALF_BANK) {
-            half.append(QByteArray(HALF_BANK - half.size(), char(0xff)));
+    std::memset(window + offset, 0xff, effectiveSize - offset);
+    rawSum += RomKernels::fillSum(offset, effectiveSize - offset, 0xff);
+    const int placedCount = starts.size();
+    comp.offsets = starts;
+    comp.offsets.resize(parts.size(), -1);
+
+    QVector<QPair<int, int>> writes;
+    relocateRomTags(window, effectiveSize, effectiveSize, comp.tags, &rawSum, &moved, &writes);
+
+    // Remember every placement.  A part another part's relocation wrote into
+    // (or that wrote outside itself) is not reusable: its bytes then depend
+    // on more than its own placement.
+    auto partAt = [&](int off) {
+        return int(std::upper_bound(starts.begin(), starts.end(), off) - starts.begin()) - 1;
+    };
+    QVector<bool> patched(placedCount, false);
+    QVector<bool> entangled(placedCount, false);
+    for (const auto& w : writes) {
+        const int target = partAt(w.second);
+        if (target < 0) continue;
+        const int source = (w.first < 0) ? target : partAt(w.first);
+        patched[target] = true;
+        if (source != target) {
+            entangled[target] = true;
+            if (source >= 0) entangled[source] = true;
         }
-
-        if (looksLikeKickstartHeader(half, HALF_BANK) || hasRomHeaderPart()) {
-            finalizeKickstartChecksum(half, HALF_BANK);
+    }
+    for (int i = 0; i < placedCount; ++i) {
+        const auto& p = parts[i];
+        if (entangled[i] || starts[i] + int(p.data.size()) > effectiveSize) continue;
+        const bool wasMoved = std::binary_search(movedParts.begin(), movedParts.end(), i);
+        if (!wasMoved && !patched[i]) {
+            comp.placements.insert(p.id, previous.value(p.id));   // unchanged
+            continue;
         }
-
-        QByteArray out;
-        out.reserve(SLOT_SIZE);
-        out.append(half);
-        out.append(half);
-        return out;
+        PlacedPart pl;
+        pl.offset = starts[i];
+        pl.effectiveSize = effectiveSize;
+        if (patched[i]) {
+            pl.bytes = QByteArray(window + starts[i], p.data.size());
+            pl.laneSums = RomKernels::laneSums(pl.bytes.constData(), pl.bytes.size());
+            pl.tags = comp.tags.section(starts[i], starts[i] + int(p.data.size()));
+        }
+        comp.placements.insert(p.id, pl);
     }
 
-    // > 256 KiB: keep linear layout and pad up to full 512 KiB bank.
-    if (base.size() < SLOT_SIZE) {
-        base.append(QByteArray(SLOT_SIZE - base.size(), char(0xff)));
+    if (looksLikeKickstartHeader(view, effectiveSize) || hasRomHeaderPart(parts)) {
+        if (sumsValid)
+            RomTools::finalizeKickChecksumFromSum(window, effectiveSize, rawSum);
+        else
+            RomTools::finalizeKickChecksum(window, effectiveSize);
     }
 
-    QByteArray out = base.left(SLOT_SIZE);
-    relocateRomTags(out, SLOT_SIZE);
-    if (looksLikeKickstartHeader(out, SLOT_SIZE)) {
+    mirrorIfHalf();
+    return comp;
+}
 
-    if (looksLikeKickstartHeader(out, SLOT_SIZE) || hasRomHeaderPart()) {
-        finalizeKickstartChecksum(out, SLOT_SIZE);
+/* ---------------------------------------------------------------------------
+   composeBanks – the 2 MiB image of all banks, composed into `dst`
+   (banks.size() × SLOT_SIZE bytes).  A bank whose cached composition is
+   current is a single copy; the others compose in parallel, each straight
+   into its own window.  Snapshots are taken here, on the GUI thread.
+   ----------------------------------------------------------------------- */
+void BankWidget::composeBanks(const QVector<BankWidget*>& banks, char* dst) {
+    struct Job {
+        QVector<RomPart> parts;
+        Placements previous;
+        QByteArray cached;      // valid composed image, or null
+        QByteArray key;         // on-disk composition cache key
+        char* window;
+    };
+    QVector<Job> jobs;
+    jobs.reserve(banks.size());
+    for (int i = 0; i < banks.size(); ++i) {
+        const BankWidget* b = banks[i];
+        Job job;
+        job.window = dst + qsizetype(i) * SLOT_SIZE;
+        if (b->m_composedGeneration == b->m_generation)
+            job.cached = b->m_composed.image;
+        else {
+            job.parts = b->m_parts;
+            job.previous = b->m_composed.placements;
+            job.key = compositionKey(job.parts);
+        }
+        jobs.push_back(std::move(job));
     }
-    return out;
-}
 
+    QtConcurrent::blockingMap(jobs, [](Job& job) {
+        if (!job.cached.isNull())
+            std::memcpy(job.window, job.cached.constData(), SLOT_SIZE);
+        else if (job.key.isEmpty() || !CompositionCache::loadImage(job.key, job.window, SLOT_SIZE))
+            composeInto(job.parts, job.window, job.previous);
+    });
+}
 
 void BankWidget::loadSinglePart(const QString& name, const QByteArray& data, bool swapped) {
+    pushUndo(captureState(QString("Load %1").arg(name)));
     m_parts.clear();
 
-    RomPart part;
-    part.name = name + (swapped ? " [swap16]" : "");
-    part.data = data.left(SLOT_SIZE);
-    part.swapped = swapped;
+    const QByteArray bytes = data.left(SLOT_SIZE);
+    const QByteArray sha = QCryptographicHash::hash(bytes, QCryptographicHash::Sha256);
+    const PartBlobPtr blob = PartPool::instance().acquire(sha, [&] { return bytes; }, [](PartBlob& b) {
+        b.tags = RomTagIndex::build(b.data);
+        b.romTagAddr = detectOriginalAddr(b.tags, QString());
+    });
+
+    RomPart part = makePart(blob, name + (swapped ? " [swap16]" : ""), swapped);
+    part.originalAddr = 0;   // monolithic image, never gap-filled
+    const QString partLabel = part.name;
+    const int partKiB = part.data.size() / 1024;
     m_parts.push_back(std::move(part));
+    markDirty();
 
     refreshUi();
     emit log(QString("Loaded into Slot %1: %2 (%3 KiB)")
-             .arg(m_bank).arg(part.name).arg(part.data.size()/1024));
+             .arg(m_bank).arg(partLabel).arg(partKiB));
 }
 
 void BankWidget::clear() {
+    if (!m_parts.isEmpty()) pushUndo(captureState("Clear"));
     m_parts.clear();
+    markDirty();
     refreshUi();
     emit log(QString("Cleared Slot %1").arg(m_bank));
 }
@@ -690,12 +929,20 @@ void BankWidget::addFiles() {
         QString(), "ROM/Parts (*.bin *.rom *.library *.device);;All (*.*)");
     if (files.isEmpty()) return;
 
+    // One undo step for the whole batch, recorded only if a file got in.
+    BankState before = captureState(files.size() == 1 ? QString("Add %1").arg(QFileInfo(files.first()).fileName())
+                                                       : QString("Add %1 files").arg(files.size()));
+    const quint64 generationBefore = m_generation;
+
     for (const QString& path : files) {
-        QFileInfo fi(path); QFile f(path);
-        if (!f.open(QIODevice::ReadOnly)) {
+        QFileInfo fi(path);
+        const MappedFile file(path);
+        if (!file.isOpen()) {
             QMessageBox::warning(this, "Open failed", fi.fileName()); continue;
         }
-        QByteArray raw = f.readAll();
+        // Mapped, not read: detection and the size checks below work on the
+        // file in place; the pool gets a (possibly swapped) copy.
+        const QByteArray raw = file.bytes();
 
         // --- Intelligent byte-order detection ---
         // 1. Extension hint (shouldAutoSwap): only .rom is swapped.
@@ -703,38 +950,30 @@ void BankWidget::addFiles() {
         //    big-endian structures (0x4AFC RomTag, Kickstart header).
         //    If the extension-based choice looks wrong, try the other order.
         bool autoSwap = shouldAutoSwap(fi);
-        QByteArray data;
 
         if (fi.suffix().toLower() == "bin") {
             // .bin is ALWAYS canonical – no second-guessing.
-            data = raw;
             autoSwap = false;
-        } else if (hasCanonicalSignatures(raw)) {
+        } else if (hasRomSignatures(CanonicalView(raw))) {
             // Raw data already looks canonical big-endian → use as-is.
-            data = raw;
             if (autoSwap) {
                 emit log(QString("Note: %1 has canonical signatures despite .rom extension; using raw data.")
                          .arg(fi.fileName()));
                 autoSwap = false;
             }
-        } else {
-            QByteArray swapped = swap16(raw);
-            if (hasCanonicalSignatures(swapped)) {
-                // Swapped data looks canonical → input was byte-swapped.
-                data = swapped;
-                if (!autoSwap) {
-                    emit log(QString("Note: auto-detected byte-swapped format for %1 (converted to canonical).")
-                             .arg(fi.fileName()));
-                }
-                autoSwap = true;
-            } else {
-                // Neither order shows recognisable structures → use extension hint.
-                data = autoSwap ? swap16(raw) : raw;
-                emit log(QString("Warning: %1 has no recognisable ROM/RomTag signatures in either byte order; "
-                                 "using extension-based heuristic (%2).")
-                         .arg(fi.fileName())
-                         .arg(autoSwap ? "swapped" : "as-is"));
+        } else if (hasRomSignatures(WordSwappedView(raw))) {
+            // Swapped view looks canonical → input was byte-swapped.
+            if (!autoSwap) {
+                emit log(QString("Note: auto-detected byte-swapped format for %1 (converted to canonical).")
+                         .arg(fi.fileName()));
             }
+            autoSwap = true;
+        } else {
+            // Neither order shows recognisable structures → use extension hint.
+            emit log(QString("Warning: %1 has no recognisable ROM/RomTag signatures in either byte order; "
+                             "using extension-based heuristic (%2).")
+                     .arg(fi.fileName())
+                     .arg(autoSwap ? "swapped" : "as-is"));
         }
 
         if (fi.fileName().contains("__rom_checksum", Qt::CaseInsensitive)) {
@@ -742,34 +981,34 @@ void BankWidget::addFiles() {
                      .arg(m_bank).arg(fi.fileName()));
             continue;
         }
-        const bool autoSwap = shouldAutoSwap(fi);
-        QByteArray data = autoSwap ? swap16(raw) : raw;
-        const QString ext = fi.suffix().toLower();
-        if (ext != "bin" && ext != "rom") {
-            emit log(QString("Slot %1 notice: treating %2 as canonical (no auto-swap).")
-                     .arg(m_bank).arg(fi.fileName()));
-        }
-        if (data.size() > SLOT_SIZE) {
+        const qsizetype dataSize = autoSwap ? ((raw.size() + 1) & ~qsizetype(1)) : raw.size();
+        if (dataSize > SLOT_SIZE) {
             QMessageBox::warning(this, "Too large",
                                  QString("%1 exceeds 512 KiB").arg(fi.fileName()));
             continue;
         }
-        if (usedBytes() + data.size() > SLOT_SIZE) {
+        if (usedBytes() + dataSize > SLOT_SIZE) {
             QMessageBox::warning(this, "Slot full",
                 QString("Adding %1 would exceed 512 KiB in Slot %2").arg(fi.fileName()).arg(m_bank));
             continue;
         }
         const int beforeBytes = usedBytes();
 
-        RomPart part;
-        part.name    = fi.fileName() + (autoSwap ? " [swap16]" : "");
-        part.data    = data;
-        part.swapped = autoSwap;
-        part.originalAddr = detectOriginalAddr(data, fi.fileName());
+        bool known = false;
+        const PartBlobPtr blob = poolBlob(path, autoSwap ? RomTools::swap16(raw) : file.copy(), autoSwap, &known);
+        if (known) {
+            emit log(QString("Slot %1: %2 shares the already loaded copy of its content.")
+                     .arg(m_bank).arg(fi.fileName()));
+        }
+
+        RomPart part = makePart(blob, fi.fileName() + (autoSwap ? " [swap16]" : ""), autoSwap);
+        part.sourcePath = fi.absoluteFilePath();
+        const QByteArray data = part.data;
 
         const QString partLabel = part.name;
         const quint32 partAddr  = part.originalAddr;
         m_parts.push_back(std::move(part));
+        markDirty();
 
         // Log first 6 bytes + detection result for diagnostics
         QString hexPrefix;
@@ -781,10 +1020,6 @@ void BankWidget::addFiles() {
                  .arg(data.size()/1024)
                  .arg(partAddr, 6, 16, QLatin1Char('0'))
                  .arg(hexPrefix.trimmed()));
-        m_parts.push_back(std::move(part));
-
-        emit log(QString("Added to Slot %1: %2 (%3 KiB)")
-                 .arg(m_bank).arg(fi.fileName() + (autoSwap ? " [swap16]" : "")).arg(data.size()/1024));
 
         const int halfBank = SLOT_SIZE / 2;
         if (beforeBytes <= halfBank && usedBytes() > halfBank) {
@@ -792,6 +1027,7 @@ void BankWidget::addFiles() {
                      .arg(m_bank));
         }
     }
+    if (m_generation != generationBefore) pushUndo(std::move(before));
     refreshUi();
 }
 
@@ -799,12 +1035,18 @@ void BankWidget::removeSelected() {
     int sel = m_list->currentRow();
     if (sel < 0 || sel >= m_parts.size()) return;
     auto name = m_parts[sel].name;
+    pushUndo(captureState(QString("Remove %1").arg(name)));
     m_parts.remove(sel);
+    markDirty();
     emit log(QString("Removed from Slot %1: %2").arg(m_bank).arg(name));
     refreshUi();
 }
 
 void BankWidget::doWriteSlot() {
+    // The reordering below is an edit of its own and can be undone.
+    BankState beforeReorder = captureState("Reorder for write");
+    const quint64 generationBefore = m_generation;
+
     if (ensureRomHeaderFirst()) {
         emit log(QString("Slot %1: moved __rom_header to first position before write.").arg(m_bank));
         refreshUi();
@@ -815,31 +1057,6 @@ void BankWidget::doWriteSlot() {
                  .arg(m_bank));
     }
 
-    // --- diagnostic: determine which build strategy will be used ---
-    static const int HALF_BANK = SLOT_SIZE / 2;
-    bool diagGapFill = (m_parts.size() > 1);
-    if (diagGapFill) {
-        for (const auto& p : m_parts) {
-            if (p.name.contains("__rom_header", Qt::CaseInsensitive)) continue;
-            if (p.originalAddr == 0) {
-                emit log(QString("Slot %1 diag: part '%2' has no detectable originalAddr → concatenation fallback")
-                         .arg(m_bank).arg(p.name));
-                diagGapFill = false;
-                break;
-            }
-        }
-    }
-    if (diagGapFill) {
-        emit log(QString("Slot %1 diag: using GAP-FILL placement (%2 parts)")
-                 .arg(m_bank).arg(m_parts.size()));
-        for (const auto& p : m_parts) {
-            emit log(QString("  %1: origAddr=0x%2, size=%3")
-                     .arg(p.name)
-                     .arg(p.originalAddr, 6, 16, QLatin1Char('0'))
-                     .arg(p.data.size()));
-        }
-    } else if (m_parts.size() > 1) {
-        emit log(QString("Slot %1 diag: using CONCATENATION fallback (gap-fill not possible)")
     const bool hadHeaderFirst = (!m_parts.isEmpty() && m_parts[0].name.contains("__rom_header", Qt::CaseInsensitive));
     int execBefore = -1; for (int i = 0; i < m_parts.size(); ++i) { if (m_parts[i].name.contains("exec", Qt::CaseInsensitive)) { execBefore = i; break; } }
     normalizeComponentOrder();
@@ -849,39 +1066,113 @@ void BankWidget::doWriteSlot() {
         emit log(QString("Slot %1: normalized component order (__rom_header first, exec early) before write.").arg(m_bank));
         refreshUi();
     }
+    if (m_generation != generationBefore) {
+        pushUndo(std::move(beforeReorder));
+        updateUndoButtons();
+    }
 
-    const auto issues = validatePartsForCurrentLayout();
-    for (const auto& issue : issues) {
-        emit log(QString("Slot %1 preflight: %2").arg(m_bank).arg(issue));
+    // Composition, checksum, diag dump and hash run on a worker: a bank
+    // can be prepared while the programmer is still busy with the previous
+    // one.  The snapshot is what this click writes, and to the programmer
+    // selected now – later edits or device switches or not.
+    const bool current = (m_composedGeneration == m_generation);
+    const QString device = m_writeTarget;
+    const quint64 sequence = ++m_writeSequence;
+    auto* watcher = new QFutureWatcher<WritePrep>(this);
+    connect(watcher, &QFutureWatcher<WritePrep>::finished, this, [this, watcher, device, sequence]() {
+        onWritePrepared(watcher->result(), device, sequence);
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&BankWidget::prepareWrite, m_bank, m_parts, m_composed.placements,
+                                         m_generation, current ? m_composed : Composition()));
+}
+
+/* ---------------------------------------------------------------------------
+   prepareWrite – everything a write needs besides the device, off the GUI
+   thread: the composition (cached, or composed now), its preflight issues,
+   the checksum check and the image on disk for inspection (the cache entry,
+   else slot%1_diag.bin) with its SHA-256.
+   ----------------------------------------------------------------------- */
+BankWidget::WritePrep BankWidget::prepareWrite(int bank, const QVector<RomPart>& parts,
+                                               const Placements& previous, quint64 generation,
+                                               const Composition& current) {
+    WritePrep w;
+    w.generation = generation;
+    w.parts = parts;
+    if (!current.image.isEmpty()) {
+        w.comp = current;
+        w.issues = validateLayout(parts, current);
+    } else {
+        Preflight r = runPreflight(parts, previous, generation);
+        w.comp = std::move(r.comp);
+        w.issues = std::move(r.issues);
     }
 
-    if (!hasRomHeaderPart()) {
-        emit log(QString("Slot %1 notice: no __rom_header part detected. Header/vectors may be incomplete for modified Kickstart ROMs.")
-                 .arg(m_bank));
+    const int effectiveSize = (w.comp.effectiveSize > 0) ? w.comp.effectiveSize : SLOT_SIZE / 2;
+    w.checksumOk = RomTools::hasValidKickChecksum(w.comp.image, effectiveSize);
+    w.sha256 = QCryptographicHash::hash(w.comp.image, QCryptographicHash::Sha256);
+
+    // The composition cache already holds this image on disk; only an
+    // uncached one is saved to temp for inspection / comparison.
+    const QByteArray cacheKey = compositionKey(parts);
+    const QString cachedPath = cacheKey.isEmpty() ? QString() : CompositionCache::imagePath(cacheKey);
+    if (!cachedPath.isEmpty() && QFileInfo::exists(cachedPath)) {
+        w.cachedPath = cachedPath;
+    } else {
+        // One dump per bank, renamed into place: concurrent prepares never
+        // tear it, and the log line carries the SHA-256 of what it holds.
+        const QString diagPath = QDir::temp().filePath(QString("slot%1_diag.bin").arg(bank));
+        QSaveFile diagFile(diagPath);
+        if (diagFile.open(QIODevice::WriteOnly) && diagFile.write(w.comp.image) == w.comp.image.size()
+            && diagFile.commit())
+            w.diagPath = diagPath;
+    }
+    return w;
+}
+
+void BankWidget::onWritePrepared(const WritePrep& w, const QString& device, quint64 sequence) {
+    // Seeds the composition cache when nothing was edited meanwhile.
+    if (w.generation == m_generation && m_composedGeneration != m_generation) {
+        m_composed = w.comp;
+        m_composedGeneration = w.generation;
     }
 
-    QByteArray img = buildTiled512k();
+    for (const auto& issue : w.issues) {
+        emit log(QString("Slot %1 preflight: %2").arg(m_bank).arg(issue));
+    }
 
-    // --- diagnostic: verify checksum ---
-    // Compute effectiveSize the same way buildTiled512k does.
-    int effectiveSize;
-    if (diagGapFill) {
-        quint32 am = 0x01000000u;
-        for (const auto& p : m_parts) {
-            if (p.name.contains("__rom_header", Qt::CaseInsensitive)) continue;
-            if (p.originalAddr != 0 && p.originalAddr < am) am = p.originalAddr;
+    const Composition& comp = w.comp;
+    const QVector<RomPart>& parts = w.parts;
+    const QByteArray& img = comp.image;
+
+    // --- diagnostic: build strategy and where every part went ---
+    if (comp.gapFilled) {
+        emit log(QString("Slot %1 diag: using GAP-FILL placement (%2 parts)")
+                 .arg(m_bank).arg(parts.size()));
+        for (int i = 0; i < parts.size(); ++i) {
+            const auto& p = parts[i];
+            const int off = comp.offsets.value(i, -1);
+            emit log(QString("  %1: origAddr=0x%2, size=%3, %4")
+                     .arg(p.name)
+                     .arg(p.originalAddr, 6, 16, QLatin1Char('0'))
+                     .arg(p.data.size())
+                     .arg(off < 0 ? QString("not placed")
+                                  : QString("@+0x%1%2").arg(off, 6, 16, QLatin1Char('0'))
+                                        .arg(p.originalAddr == 0 && off > 0 ? " (best-fit gap)" : "")));
         }
-        effectiveSize = (am < 0x00FC0000u) ? SLOT_SIZE : HALF_BANK;
-    } else {
-        effectiveSize = (usedBytes() <= HALF_BANK) ? HALF_BANK : SLOT_SIZE;
+    } else if (parts.size() > 1) {
+        emit log(QString("Slot %1 diag: using CONCATENATION fallback (no part with a usable originalAddr, or parts do not fit)")
+                 .arg(m_bank));
     }
-    const bool csOk = verifyKickstartChecksum(img, effectiveSize);
+
+    // --- diagnostic: verify checksum ---
+    const int effectiveSize = (comp.effectiveSize > 0) ? comp.effectiveSize : SLOT_SIZE / 2;
     const quint32 csVal = readBe32(img, effectiveSize - 4);
     emit log(QString("Slot %1 diag: effectiveSize=%2, checksum=0x%3, verify=%4")
              .arg(m_bank)
              .arg(effectiveSize)
              .arg(csVal, 8, 16, QLatin1Char('0'))
-             .arg(csOk ? "PASS" : "FAIL"));
+             .arg(w.checksumOk ? "PASS" : "FAIL"));
 
     // Log first 8 bytes (reset vectors) for sanity
     if (img.size() >= 8) {
@@ -897,34 +1188,31 @@ void BankWidget::doWriteSlot() {
                  .arg(quint8(img[7]), 2, 16, QLatin1Char('0')));
     }
 
-    // Save diagnostic image to temp for inspection / comparison
-    {
-        const QString diagPath = QDir::temp().filePath(QString("slot%1_diag.bin").arg(m_bank));
-        QFile diagFile(diagPath);
-        if (diagFile.open(QIODevice::WriteOnly)) {
-            diagFile.write(img);
-            diagFile.close();
-            const QByteArray sha = QCryptographicHash::hash(img, QCryptographicHash::Sha256).toHex().left(16);
-            emit log(QString("Slot %1 diag: image saved to %2 (%3 bytes, sha256=%4…)")
-                     .arg(m_bank).arg(diagPath).arg(img.size()).arg(QString::fromLatin1(sha)));
-        }
+    const QString sha = QString::fromLatin1(w.sha256.toHex().left(16));
+    if (!w.cachedPath.isEmpty()) {
+        emit log(QString("Slot %1 diag: image cached at %2 (sha256=%3…)").arg(m_bank).arg(w.cachedPath).arg(sha));
+    } else if (!w.diagPath.isEmpty()) {
+        emit log(QString("Slot %1 diag: image saved to %2 (%3 bytes, sha256=%4…)")
+                 .arg(m_bank).arg(w.diagPath).arg(img.size()).arg(sha));
     }
 
-    emit requestWriteSlot(m_bank, img);
+    emit requestWriteSlot(m_bank, img, device, sequence);
 }
 
-QStringList BankWidget::validatePartRomTags(int effectiveSize) const {
+QStringList BankWidget::validatePartRomTags(const QVector<RomPart>& parts, const QVector<int>& offsets,
+                                            int effectiveSize) {
     QStringList issues;
     if (effectiveSize <= 0) return issues;
 
     const quint32 baseAddr = 0x01000000u - quint32(effectiveSize);
-    int absOffset = 0;
-    for (const auto& part : m_parts) {
-        const int partStart = absOffset;
-        const QByteArray& data = part.data;
-        for (int off = 0; off + 26 <= data.size(); ++off) {
-            if (readBe16(data, off) != 0x4AFC) continue;
-            const quint32 matchTag = readBe32(data, off + 2) & 0x00FFFFFFu;
+    for (int i = 0; i < parts.size() && i < offsets.size(); ++i) {
+        const auto& part = parts[i];
+        const int partStart = offsets[i];
+        if (partStart < 0) continue;   // not in the image
+        const RomTagIndex& tags = part.tags;
+        for (int t = 0; t < tags.size(); ++t) {
+            const int off = tags.offset[t];
+            const quint32 matchTag = tags.matchTag[t];
             const quint32 expected = (baseAddr + quint32(partStart + off)) & 0x00FFFFFFu;
             if (matchTag != expected) {
                 issues << QString("Part '%1': RomTag @+0x%2 has rt_MatchTag=0x%3 (expected 0x%4 after current placement)")
@@ -938,24 +1226,37 @@ QStringList BankWidget::validatePartRomTags(int effectiveSize) const {
                 }
             }
         }
-        absOffset += part.data.size();
     }
     return issues;
 }
 
-QStringList BankWidget::validatePartsForCurrentLayout() const {
+QStringList BankWidget::validateLayout(const QVector<RomPart>& parts, const Composition& comp) {
     QStringList issues;
-    if (m_parts.isEmpty()) return issues;
+    if (parts.isEmpty()) return issues;
 
-    const int effectiveSize = (usedBytes() <= SLOT_SIZE / 2) ? SLOT_SIZE / 2 : SLOT_SIZE;
+    const int effectiveSize = (comp.effectiveSize > 0) ? comp.effectiveSize
+                            : (payloadBytes(parts) <= SLOT_SIZE / 2) ? SLOT_SIZE / 2 : SLOT_SIZE;
     if (effectiveSize <= 0) return issues;
 
-    issues << validatePartRomTags(effectiveSize);
+    // Collisions come straight from the layout, no scan of the image.
+    for (const auto& o : comp.overlaps) {
+        issues << QString("Part '%1' overlaps '%2' at +0x%3..+0x%4 (later part wins)")
+                      .arg(parts.value(o.second).name)
+                      .arg(parts.value(o.first).name)
+                      .arg(o.from, 6, 16, QLatin1Char('0'))
+                      .arg(o.to, 6, 16, QLatin1Char('0'));
+    }
+    for (int i = 0; i < parts.size() && i < comp.offsets.size(); ++i) {
+        if (comp.offsets[i] < 0)
+            issues << QString("Part '%1' does not fit into the %2 KiB layout and is left out")
+                          .arg(parts[i].name).arg(effectiveSize / 1024);
+    }
+
+    issues << validatePartRomTags(parts, comp.offsets, effectiveSize);
 
-    QByteArray img = buildTiled512k();
-    if (looksLikeKickstartHeader(img, effectiveSize)) {
-        issues << validateRomTags(img, effectiveSize);
-        if (!hasRomHeaderPart()) {
+    if (looksLikeKickstartHeader(comp.image, effectiveSize)) {
+        issues << validateRomTags(comp.tags, effectiveSize);
+        if (!hasRomHeaderPart(parts)) {
             issues << "No __rom_header part present; header/vectors may be incomplete.";
         }
     }
@@ -969,6 +1270,7 @@ bool BankWidget::ensureRomHeaderFirst() {
         if (i == 0) return false;
         RomPart header = m_parts.takeAt(i);
         m_parts.prepend(std::move(header));
+        markDirty();
         return true;
     }
     return false;
@@ -993,28 +1295,334 @@ void BankWidget::normalizeComponentOrder() {
         if (i == target) return;
         RomPart exec = m_parts.takeAt(i);
         m_parts.insert(target, std::move(exec));
+        markDirty();
         return;
     }
 }
 
 bool BankWidget::hasRomHeaderPart() const {
-    for (const auto& p : m_parts) {
+    return hasRomHeaderPart(m_parts);
+}
+
+bool BankWidget::hasRomHeaderPart(const QVector<RomPart>& parts) {
+    for (const auto& p : parts) {
         if (p.name.contains("__rom_header", Qt::CaseInsensitive)) return true;
     }
     return false;
 }
 
+/* ---------------------------------------------------------------------------
+   Hot reload – the watcher follows the source file of every part.  Saves
+   are debounced, read and analysed on a worker (the pool dedups as usual)
+   and applied on the GUI thread: every part from that file gets the new
+   blob under a new id, so the next composition re-places, relocates and
+   re-checksums only what changed; unchanged parts keep their placements.
+   ----------------------------------------------------------------------- */
+void BankWidget::syncWatchedPaths() {
+    QSet<QString> wanted;
+    for (const auto& p : m_parts) {
+        if (!p.sourcePath.isEmpty()) wanted.insert(p.sourcePath);
+    }
+    const QStringList watched = m_sourceWatcher->files();
+    for (const auto& w : watched) {
+        if (!wanted.contains(w)) m_sourceWatcher->removePath(w);
+    }
+    for (const auto& w : wanted) {
+        // Saved by rename (most editors) → the watch is gone, re-add it.
+        if (!watched.contains(w) && QFileInfo::exists(w)) m_sourceWatcher->addPath(w);
+    }
+}
+
+void BankWidget::onSourceChanged(const QString& path) {
+    m_pendingReloads.insert(path);
+    m_reloadTimer->start();
+}
+
+BankWidget::Reload BankWidget::reloadPartFile(const QString& path, bool swap) {
+    Reload r;
+    r.path = path;
+    // Read, not mapped: the file may be rewritten in place right now, and a
+    // truncation under a mapping would fault the whole process.
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        r.error = file.errorString();
+        return r;
+    }
+    const qint64 expected = file.size();
+    const qsizetype size = swap ? ((expected + 1) & ~qsizetype(1)) : expected;
+    if (size > SLOT_SIZE) {
+        r.error = "exceeds 512 KiB";
+        return r;
+    }
+    const QByteArray raw = file.read(SLOT_SIZE + 1);
+    if (raw.size() != expected || QFileInfo(path).size() != expected) {
+        // Still being written; the watcher reports the next change.
+        r.error = "file changed while reading";
+        return r;
+    }
+    r.blob = poolBlob(path, swap ? RomTools::swap16(raw) : raw, swap);
+    return r;
+}
+
+void BankWidget::startReloads() {
+    const QSet<QString> paths = std::exchange(m_pendingReloads, {});
+    for (const auto& path : paths) {
+        bool swap = false;
+        bool used = false;
+        for (const auto& p : m_parts) {
+            if (p.sourcePath != path) continue;
+            swap = p.swapped;
+            used = true;
+            break;
+        }
+        if (!used) continue;
+        if (m_reloading.contains(path)) {
+            // One read per file at a time: this change is read after it.
+            m_pendingReloads.insert(path);
+            continue;
+        }
+        if (!QFileInfo::exists(path)) {
+            // Mid-save (deleted, not yet renamed into place): look again.
+            m_pendingReloads.insert(path);
+            m_reloadTimer->start();
+            continue;
+        }
+
+        m_reloading.insert(path);
+        auto* watcher = new QFutureWatcher<Reload>(this);
+        connect(watcher, &QFutureWatcher<Reload>::finished, this, [this, watcher, path]() {
+            m_reloading.remove(path);
+            watcher->deleteLater();
+            if (m_pendingReloads.contains(path)) {
+                // Changed again while being read: only the newer read counts.
+                m_reloadTimer->start();
+                return;
+            }
+            applyReload(watcher->result());
+        });
+        watcher->setFuture(QtConcurrent::run(&BankWidget::reloadPartFile, path, swap));
+    }
+}
+
+void BankWidget::applyReload(const Reload& r) {
+    const QString fileName = QFileInfo(r.path).fileName();
+    if (!r.blob) {
+        emit log(QString("Slot %1: reload of %2 failed (%3); keeping the loaded copy.")
+                 .arg(m_bank).arg(fileName).arg(r.error));
+        syncWatchedPaths();
+        return;
+    }
+
+    int oldBytes = 0;
+    int hits = 0;
+    for (const auto& p : m_parts) {
+        if (p.sourcePath != r.path || p.sha256 == r.blob->sha256) continue;
+        oldBytes += int(p.data.size());
+        ++hits;
+    }
+    if (hits == 0) {          // touched, not changed (or removed meanwhile)
+        syncWatchedPaths();
+        return;
+    }
+    if (usedBytes() - oldBytes + hits * int(r.blob->data.size()) > SLOT_SIZE) {
+        emit log(QString("Slot %1: reloaded %2 no longer fits into 512 KiB; keeping the loaded copy.")
+                 .arg(m_bank).arg(fileName));
+        syncWatchedPaths();
+        return;
+    }
+
+    pushUndo(captureState(QString("Reload %1").arg(fileName)));
+    for (auto& p : m_parts) {
+        if (p.sourcePath != r.path || p.sha256 == r.blob->sha256) continue;
+        RomPart fresh = makePart(r.blob, p.name, p.swapped);
+        fresh.sourcePath = p.sourcePath;
+        p = std::move(fresh);
+    }
+    markDirty();
+    emit log(QString("Slot %1: reloaded %2 (%3 KiB, %4 placement(s)).")
+             .arg(m_bank).arg(fileName).arg(r.blob->data.size() / 1024).arg(hits));
+    refreshUi();
+}
+
+/* ---------------------------------------------------------------------------
+   Undo/redo – every edit first pushes the state it replaces.  States share
+   their part lists and composed images with the live bank (implicit
+   sharing), so a step costs a few handles, not bytes; restoring one that
+   carried a current composition seeds the cache instead of recomposing.
+   ----------------------------------------------------------------------- */
+BankWidget::BankState BankWidget::captureState(const QString& label) const {
+    BankState st;
+    st.label = label;
+    st.parts = m_parts;
+    st.composedValid = (m_composedGeneration == m_generation);
+    if (st.composedValid) st.composed = m_composed;
+    return st;
+}
+
+void BankWidget::pushUndo(BankState state) {
+    m_undo.push_back(std::move(state));
+    if (m_undo.size() > MAX_UNDO) m_undo.removeFirst();
+    m_redo.clear();
+}
+
+void BankWidget::restoreState(const BankState& state) {
+    m_parts = state.parts;
+    markDirty();
+    if (state.composedValid) {
+        m_composed = state.composed;
+        m_composedGeneration = m_generation;
+    }
+    refreshUi();
+}
+
+void BankWidget::undo() {
+    if (m_undo.isEmpty()) return;
+    BankState st = m_undo.takeLast();
+    m_redo.push_back(captureState(st.label));
+    restoreState(st);
+    emit log(QString("Slot %1: undo %2").arg(m_bank).arg(st.label));
+}
+
+void BankWidget::redo() {
+    if (m_redo.isEmpty()) return;
+    BankState st = m_redo.takeLast();
+    m_undo.push_back(captureState(st.label));
+    restoreState(st);
+    emit log(QString("Slot %1: redo %2").arg(m_bank).arg(st.label));
+}
+
+void BankWidget::updateUndoButtons() {
+    m_btnUndo->setEnabled(!m_undo.isEmpty());
+    m_btnUndo->setToolTip(m_undo.isEmpty() ? QString() : QString("Undo %1").arg(m_undo.last().label));
+    m_btnRedo->setEnabled(!m_redo.isEmpty());
+    m_btnRedo->setToolTip(m_redo.isEmpty() ? QString() : QString("Redo %1").arg(m_redo.last().label));
+}
+
+/* ---------------------------------------------------------------------------
+   Preflight – validation of the current layout off the GUI thread.
+
+   Edits only (re)start a short debounce timer; the worker then composes and
+   validates a snapshot of m_parts (implicitly shared, so the snapshot is
+   free) tagged with the generation it was taken at.  A result whose
+   generation is no longer current is dropped and the check re-run; a
+   current one also seeds the composition cache for save/write.
+   ----------------------------------------------------------------------- */
+BankWidget::Preflight BankWidget::runPreflight(const QVector<RomPart>& parts, const Placements& previous,
+                                               quint64 generation) {
+    Preflight r;
+    const QByteArray key = compositionKey(parts);
+    if (!key.isEmpty() && loadCachedPreflight(key, &r)) {
+        r.generation = generation;
+        return r;
+    }
+
+    r.generation = generation;
+    r.comp = composeBank(parts, previous);
+    r.issues = validateLayout(parts, r.comp);
+    if (!key.isEmpty())
+        CompositionCache::store(key, r.comp.image, preflightReport(r));
+    return r;
+}
+
+/* ---------------------------------------------------------------------------
+   On-disk composition cache – the same parts in the same order compose to
+   the same bank.  The key covers every input of composeInto(): the part
+   digests in order, the part names (the header is placed by name, the
+   report quotes them) and the layout options; the entry holds the image
+   and the preflight report.
+   Placements are not cached: after a hit the next edit relocates in full.
+   ----------------------------------------------------------------------- */
+QByteArray BankWidget::compositionKey(const QVector<RomPart>& parts) {
+    if (parts.isEmpty()) return QByteArray();
+    QVector<QByteArray> digests;
+    digests.reserve(parts.size());
+    for (const auto& p : parts) {
+        if (p.sha256.isEmpty()) return QByteArray();   // part not hashed → no cache
+        digests.push_back(p.sha256 + p.name.toUtf8());
+    }
+    const QByteArray options = QString("compose=%1;slot=%2")
+                                   .arg(COMPOSITION_VERSION).arg(SLOT_SIZE).toLatin1();
+    return CompositionCache::key(digests, options);
+}
+
+QJsonObject BankWidget::preflightReport(const Preflight& r) {
+    QJsonObject o;
+    o["effectiveSize"] = r.comp.effectiveSize;
+    o["gapFilled"] = r.comp.gapFilled;
+    QJsonArray offsets;
+    for (const int off : r.comp.offsets) offsets.append(off);
+    o["offsets"] = offsets;
+    QJsonArray overlaps;
+    for (const auto& ov : r.comp.overlaps)
+        overlaps.append(QJsonArray{ ov.first, ov.second, ov.from, ov.to });
+    o["overlaps"] = overlaps;
+    QJsonArray tags;
+    for (const int off : r.comp.tags.offset) tags.append(off);
+    o["romTags"] = tags;
+    o["issues"] = QJsonArray::fromStringList(r.issues);
+    return o;
+}
+
+bool BankWidget::loadCachedPreflight(const QByteArray& key, Preflight* out) {
+    QByteArray image;
+    QJsonObject o;
+    if (!CompositionCache::load(key, SLOT_SIZE, &image, &o)) return false;
+
+    Composition comp;
+    comp.effectiveSize = o.value("effectiveSize").toInt();
+    comp.gapFilled = o.value("gapFilled").toBool();
+    for (const auto& v : o.value("offsets").toArray()) comp.offsets.push_back(v.toInt(-1));
+    for (const auto& v : o.value("overlaps").toArray()) {
+        const QJsonArray a = v.toArray();
+        comp.overlaps.push_back(RomLayout::Overlap{ a.at(0).toInt(), a.at(1).toInt(),
+                                                    a.at(2).toInt(), a.at(3).toInt() });
+    }
+    // RomTags at their recorded offsets – decoded, not searched.
+    QVector<int> tagOffsets;
+    for (const auto& v : o.value("romTags").toArray()) tagOffsets.push_back(v.toInt(-1));
+    comp.tags = RomTagIndex::fromSites(image, tagOffsets);
+    if (comp.tags.size() != tagOffsets.size()) return false;
+    comp.image = std::move(image);
+
+    out->comp = std::move(comp);
+    out->issues.clear();
+    for (const auto& v : o.value("issues").toArray()) out->issues << v.toString();
+    return true;
+}
+
 void BankWidget::updateWriteButtonState() {
-    const auto issues = validatePartsForCurrentLayout();
-    if (issues.isEmpty()) {
+    m_btnWrite->setToolTip(QString("Slot %1 preflight: checking…").arg(m_bank));
+    m_preflightTimer->start();   // restarts on every edit
+}
+
+void BankWidget::startPreflight() {
+    // One check at a time; onPreflightFinished() catches up if parts changed meanwhile.
+    if (m_preflightWatcher->isRunning()) return;
+    m_preflightWatcher->setFuture(QtConcurrent::run(&BankWidget::runPreflight, m_parts,
+                                                    m_composed.placements, m_generation));
+}
+
+void BankWidget::onPreflightFinished() {
+    const Preflight r = m_preflightWatcher->result();
+    if (r.generation != m_generation) {
+        if (!m_preflightTimer->isActive()) startPreflight();
+        return;
+    }
+
+    if (m_composedGeneration != r.generation) {
+        m_composed = r.comp;
+        m_composedGeneration = r.generation;
+    }
+
+    if (r.issues.isEmpty()) {
         m_btnWrite->setToolTip(QString("Slot %1 preflight: no obvious issues detected.").arg(m_bank));
         return;
     }
 
     m_btnWrite->setToolTip(QString("Slot %1 preflight warnings (%2):\n- %3")
                            .arg(m_bank)
-                           .arg(issues.size())
-                           .arg(issues.join("\n- ")));
+                           .arg(r.issues.size())
+                           .arg(r.issues.join("\n- ")));
 }
 
 void BankWidget::refreshUi() {
@@ -1031,6 +1639,8 @@ void BankWidget::refreshUi() {
         seg.push_back(p.data.size());
     }
     m_meter->setSegments(seg);
+    updateUndoButtons();
+    syncWatchedPaths();
 
     const int used = usedBytes();
     const int halfBank = SLOT_SIZE / 2;
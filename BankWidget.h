@@ -7,12 +7,33 @@
 #include <QFileInfo>
 #include <QStringList>
 #include <QtGlobal>
+#include <QTimer>
+#include <QFutureWatcher>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QHash>
+#include <QPair>
+#include <QJsonObject>
 
+#include "PartPool.h"
+#include "RomKernels.h"
+#include "RomLayout.h"
+#include "RomTagIndex.h"
+
+// One placement of a part in a bank.  Bytes and everything derived from
+// them come from the shared PartPool blob; data, sha256, laneSums and tags
+// are implicitly shared handles onto it, not copies.
 struct RomPart {
+    quint64     id = 0;  // unique per loaded part (placement cache key)
     QString     name;
+    PartBlobPtr blob;   // pooled bytes + metadata, keeps them alive
+    QString     sourcePath; // file the part was loaded from, empty = none (watched for reloads)
     QByteArray  data;   // ggf. bereits swap16-konvertiert
+    QByteArray  sha256; // of data, part of the composition cache key
     bool        swapped = false;
     quint32     originalAddr = 0; // original absolute ROM address (from rt_MatchTag), 0 = unknown/header
+    RomKernels::LaneSums laneSums; // per-lane byte sums of data → checksum contribution at any offset
+    RomTagIndex tags;              // RomTags of data, parsed once per distinct content
 };
 
 class MeterBar : public QWidget {
@@ -34,53 +55,172 @@ public:
     explicit BankWidget(int bankIndex, QWidget* parent=nullptr);
 
     static constexpr int SLOT_SIZE = 512 * 1024;
+    // Bump whenever composeInto() would produce different bytes for the
+    // same parts; it is part of every on-disk composition cache key.
+    static constexpr int COMPOSITION_VERSION = 1;
 
     int bank() const { return m_bank; }
     int usedBytes() const;
     QByteArray buildTiled512k() const;   // <=256KiB: auf 256KiB auffüllen+spiegeln; >256KiB: auf 512KiB mit 0xFF
+    // Alle Banks direkt in dst (banks.size() × SLOT_SIZE) komponieren, parallel.
+    static void composeBanks(const QVector<BankWidget*>& banks, char* dst);
     void clear();
     void loadSinglePart(const QString& name, const QByteArray& data, bool swapped = false);
+    // Programmer a Write Slot click goes to ("" = Auto), fixed at the click.
+    void setWriteTarget(const QString& device) { m_writeTarget = device; }
 
 signals:
-    void requestWriteSlot(int bank, const QByteArray& img512k);
+    // sequence counts this bank's Write Slot clicks; prepares can finish out
+    // of order, so a lower one than already seen is stale.
+    void requestWriteSlot(int bank, const QByteArray& img512k, const QString& device, quint64 sequence);
     void log(const QString& line);
 
 public slots:
     void addFiles();
     void removeSelected();
     void doWriteSlot();
+    void undo();
+    void redo();
 
 private:
-    static QByteArray swap16(const QByteArray& in);
+    // Where a part went in the last concatenation and what relocation made
+    // of it.  `bytes` is null when relocation left the part untouched.
+    struct PlacedPart {
+        int         offset = 0;
+        int         effectiveSize = 0;
+        QByteArray  bytes;                 // relocated part bytes
+        RomKernels::LaneSums laneSums;     // of `bytes`
+        RomTagIndex tags;                  // part-relative, after relocation
+    };
+    using Placements = QHash<quint64, PlacedPart>;
+
+    // One composed bank: the 512 KiB image, the RomTags in it (after
+    // relocation, mirror included), the size the checksum covers and where
+    // every part ended up.
+    struct Composition {
+        QByteArray  image;
+        RomTagIndex tags;
+        int         effectiveSize = 0;
+        Placements  placements;            // by RomPart::id, concat path only
+        bool        gapFilled = false;     // parts at their original addresses
+        QVector<int> offsets;              // image offset per part, -1 = not placed
+        QVector<RomLayout::Overlap> overlaps;  // by part index, gap-fill only
+    };
+
+    // Result of one background preflight run over a parts snapshot.
+    struct Preflight {
+        quint64     generation = 0;
+        Composition comp;
+        QStringList issues;
+    };
+
+    // One undo/redo step.  The part list is implicitly shared with the live
+    // one (an edit detaches O(parts) handles, never bytes); the composition
+    // is kept when it was current, so stepping back does not recompose.
+    struct BankState {
+        QString          label;
+        QVector<RomPart> parts;
+        Composition      composed;
+        bool             composedValid = false;
+    };
+    static constexpr int MAX_UNDO = 64;
+
+    // Everything one write needs, prepared on a worker (doWriteSlot).
+    struct WritePrep {
+        quint64          generation = 0;
+        QVector<RomPart> parts;          // snapshot the image was composed from
+        Composition      comp;
+        QStringList      issues;
+        bool             checksumOk = false;
+        QByteArray       sha256;         // of comp.image
+        QString          cachedPath;     // image in the composition cache, or
+        QString          diagPath;       // dumped to temp (empty: neither)
+    };
+
+    // Background reload of one changed source file.
+    struct Reload {
+        QString     path;
+        PartBlobPtr blob;   // null on failure
+        QString     error;
+    };
+
+    // `previous` placements let unmoved parts skip relocation.
+    static Composition composeBank(const QVector<RomPart>& parts, const Placements& previous = {});
+    static Composition composeInto(const QVector<RomPart>& parts, char* window,
+                                   const Placements& previous = {});
+    static QByteArray compositionKey(const QVector<RomPart>& parts);
+    static bool loadCachedPreflight(const QByteArray& key, Preflight* out);
+    static QJsonObject preflightReport(const Preflight& r);
+    static quint64 nextPartId();
+    static RomPart makePart(const PartBlobPtr& blob, const QString& name, bool swapped);
+    static PartBlobPtr poolBlob(const QString& path, const QByteArray& canonical, bool swapped,
+                                bool* known = nullptr);
+    static Reload reloadPartFile(const QString& path, bool swap);
+    void onSourceChanged(const QString& path);
+    void startReloads();
+    void applyReload(const Reload& r);
+    void syncWatchedPaths();
+    const Composition& composition() const;   // cached composeBank(m_parts)
+    void markDirty();                         // call after every m_parts change
     static bool shouldAutoSwap(const QFileInfo& fi);
-    static bool hasCanonicalSignatures(const QByteArray& data);
     static quint32 readBe32(const QByteArray& in, int off);
     static quint16 readBe16(const QByteArray& in, int off);
-    static void writeBe32(QByteArray& out, int off, quint32 v);
-    static void finalizeKickstartChecksum(QByteArray& image, int effectiveSize);
     static bool looksLikeKickstartHeader(const QByteArray& image, int effectiveSize);
-    static QStringList validateRomTags(const QByteArray& image, int effectiveSize);
-    static int relocateRomTags(QByteArray& image, int effectiveSize);
-    static quint32 detectOriginalAddr(const QByteArray& data, const QString& name);
-    static bool verifyKickstartChecksum(const QByteArray& image, int effectiveSize);
-    QStringList validatePartRomTags(int effectiveSize) const;
-    QStringList validatePartsForCurrentLayout() const;
-    bool ensureRomHeaderFirst();
-    QStringList validatePartRomTags(int effectiveSize) const;
-    QStringList validatePartsForCurrentLayout() const;
+    static QStringList validateRomTags(const RomTagIndex& tags, int effectiveSize);
+    static int relocateRomTags(char* data, int size, int effectiveSize, RomTagIndex& tags,
+                               quint64* rawSum = nullptr,
+                               const QVector<QPair<int, int>>* ranges = nullptr,
+                               QVector<QPair<int, int>>* writes = nullptr);
+    static quint32 detectOriginalAddr(const RomTagIndex& tags, const QString& name);
+    static QStringList validatePartRomTags(const QVector<RomPart>& parts, const QVector<int>& offsets,
+                                           int effectiveSize);
+    static QStringList validateLayout(const QVector<RomPart>& parts, const Composition& comp);
+    static Preflight runPreflight(const QVector<RomPart>& parts, const Placements& previous,
+                                  quint64 generation);
+    static WritePrep prepareWrite(int bank, const QVector<RomPart>& parts, const Placements& previous,
+                                  quint64 generation, const Composition& current);
+    void onWritePrepared(const WritePrep& w, const QString& device, quint64 sequence);
+    void startPreflight();
+    void onPreflightFinished();
+    static int payloadBytes(const QVector<RomPart>& parts);
     bool ensureRomHeaderFirst();
     void normalizeComponentOrder();
     bool hasRomHeaderPart() const;
+    static bool hasRomHeaderPart(const QVector<RomPart>& parts);
     void refreshUi();
     void updateWriteButtonState();
+    BankState captureState(const QString& label) const;
+    void pushUndo(BankState state);           // before an edit; drops redo
+    void restoreState(const BankState& state);
+    void updateUndoButtons();
 
     int m_bank;
+    QString m_writeTarget;
     QListWidget* m_list;
     MeterBar*    m_meter;
     QPushButton* m_btnAdd;
     QPushButton* m_btnRemove;
     QPushButton* m_btnClear;
     QPushButton* m_btnWrite;
+    QPushButton* m_btnUndo;
+    QPushButton* m_btnRedo;
 
     QVector<RomPart> m_parts;
+    QVector<BankState> m_undo;   // oldest first
+    QVector<BankState> m_redo;   // next redo last
+
+    // Composition cache: valid while m_composedGeneration == m_generation.
+    quint64 m_generation = 0;
+    mutable quint64 m_composedGeneration = ~quint64(0);
+    mutable Composition m_composed;
+
+    QFileSystemWatcher* m_sourceWatcher = nullptr;      // sourcePath of every part
+    QTimer* m_reloadTimer = nullptr;                    // debounce for saves on disk
+    QSet<QString> m_pendingReloads;
+    QSet<QString> m_reloading;                          // read in flight, at most one per path
+
+    quint64 m_writeSequence = 0;                        // Write Slot clicks so far
+
+    QTimer* m_preflightTimer = nullptr;                 // debounce for edits
+    QFutureWatcher<Preflight>* m_preflightWatcher = nullptr;
 };
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+#include <QtGlobal>
+
+#include "RomKernels.h"
+
+using RomKernels::ByteOrder;
+
+/* ---------------------------------------------------------------------------
+   ByteOrderView – read-only canonical (big-endian) access to a raw buffer
+   that is stored either canonical or word-swapped.
+
+   Signature detection and RomTag scanning run directly on the raw bytes in
+   either order; a real swapped copy is only made via materialize()/mid()
+   once the data is actually committed.  A word-swapped view of an odd-sized
+   buffer behaves like swap16(): padded with 0xFF to an even size.
+   The view does not own the bytes – the buffer must outlive it.
+   ----------------------------------------------------------------------- */
+template <ByteOrder Order>
+class ByteOrderView {
+public:
+    ByteOrderView(const char* data, qsizetype size)
+        : m_data(reinterpret_cast<const unsigned char*>(data)), m_rawSize(size) {}
+    explicit ByteOrderView(const QByteArray& raw)
+        : ByteOrderView(raw.constData(), raw.size()) {}
+
+    static constexpr ByteOrder order() { return Order; }
+
+    const char* rawData() const { return reinterpret_cast<const char*>(m_data); }
+    qsizetype rawSize() const { return m_rawSize; }
+
+    qsizetype size() const {
+        return (Order == ByteOrder::Canonical) ? m_rawSize : ((m_rawSize + 1) & ~qsizetype(1));
+    }
+    bool isEmpty() const { return m_rawSize == 0; }
+
+    unsigned char at(qsizetype i) const {
+        if (Order == ByteOrder::Canonical) return m_data[i];
+        const qsizetype j = i ^ 1;
+        return (j < m_rawSize) ? m_data[j] : 0xff;
+    }
+
+    quint16 be16(qsizetype off) const {
+        if (off < 0 || off + 2 > size()) return 0;
+        return quint16((quint16(at(off)) << 8) | at(off + 1));
+    }
+
+    quint32 be32(qsizetype off) const {
+        if (off < 0 || off + 4 > size()) return 0;
+        return (quint32(at(off)) << 24) | (quint32(at(off + 1)) << 16)
+             | (quint32(at(off + 2)) << 8) | quint32(at(off + 3));
+    }
+
+    QVector<int> romTagCandidates(RomKernels::TagStride stride, qsizetype minSpan = 2) const {
+        return RomKernels::findRomTagCandidates(rawData(), m_rawSize, stride, minSpan, Order);
+    }
+
+    // Canonical copy of [off, off + len).
+    QByteArray mid(qsizetype off, qsizetype len) const {
+        if (off < 0 || off >= size()) return {};
+        len = qMin(len, size() - off);
+        if (Order == ByteOrder::Canonical) return QByteArray(rawData() + off, len);
+        if ((off & 1) == 0) {
+            // Word-aligned: swap the covering raw words in one kernel call.
+            const qsizetype n = qMin(len + (len & 1), m_rawSize - off);
+            QByteArray out((n + 1) & ~qsizetype(1), Qt::Uninitialized);
+            RomKernels::swap16Copy(rawData() + off, n, out.data());
+            out.truncate(len);
+            return out;
+        }
+        QByteArray out(len, Qt::Uninitialized);
+        for (qsizetype i = 0; i < len; ++i) out[i] = char(at(off + i));
+        return out;
+    }
+
+    QByteArray materialize() const { return mid(0, size()); }
+
+private:
+    const unsigned char* m_data;
+    qsizetype m_rawSize;
+};
+
+using CanonicalView = ByteOrderView<ByteOrder::Canonical>;
+using WordSwappedView = ByteOrderView<ByteOrder::WordSwapped>;
+
+/* ---------------------------------------------------------------------------
+   hasRomSignatures – does the view look like canonical big-endian Amiga ROM
+   content?  Checks for RomTag magic (0x4AFC) and Kickstart header patterns
+   at plausible positions.
+   ----------------------------------------------------------------------- */
+template <ByteOrder Order>
+bool hasRomSignatures(const ByteOrderView<Order>& v) {
+    if (v.size() < 2) return false;
+
+    // Check first word for RomTag magic.
+    if (v.be16(0) == 0x4AFC) return true;
+
+    // Kickstart header: 0x1111 0x4EF9  or  0x4EF9 at word 0.
+    if (v.size() >= 4) {
+        const quint16 w0 = v.be16(0);
+        const quint16 w1 = v.be16(2);
+        if (w0 == 0x1111 && w1 == 0x4EF9) return true;
+        if (w0 == 0x4EF9) return true;
+    }
+
+    // Scan first 256 bytes for RomTag (some components have a small preamble).
+    for (qsizetype off = 2; off + 2 <= qMin<qsizetype>(v.size(), 256); off += 2) {
+        if (v.be16(off) == 0x4AFC) return true;
+    }
+    return false;
+}
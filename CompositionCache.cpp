@@ -0,0 +1,87 @@
+#include "CompositionCache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace CompositionCache {
+
+static QString reportPath(const QByteArray& key) {
+    return QDir(directory()).filePath(QString::fromLatin1(key) + ".json");
+}
+
+static bool writeAtomically(const QString& path, const QByteArray& bytes) {
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+    if (f.write(bytes) != bytes.size()) {
+        f.cancelWriting();
+        return false;
+    }
+    return f.commit();
+}
+
+static void prune() {
+    QDir dir(directory());
+    const QFileInfoList reports = dir.entryInfoList(QStringList() << "*.json", QDir::Files, QDir::Time);
+    for (int i = MAX_ENTRIES; i < reports.size(); ++i) {
+        const QString base = reports[i].completeBaseName();
+        dir.remove(base + ".json");   // report first: the entry is gone
+        dir.remove(base + ".bin");
+    }
+}
+
+QByteArray key(const QVector<QByteArray>& partDigests, const QByteArray& options) {
+    QCryptographicHash h(QCryptographicHash::Sha256);
+    h.addData(options);
+    for (const auto& d : partDigests) {
+        h.addData(QByteArray(1, '|'));
+        h.addData(d);
+    }
+    return h.result().toHex();
+}
+
+QString directory() {
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("compositions");
+}
+
+QString imagePath(const QByteArray& key) {
+    return QDir(directory()).filePath(QString::fromLatin1(key) + ".bin");
+}
+
+bool load(const QByteArray& key, qsizetype imageSize, QByteArray* image, QJsonObject* report) {
+    QFile rf(reportPath(key));
+    if (!rf.open(QIODevice::ReadOnly)) return false;
+    const auto doc = QJsonDocument::fromJson(rf.readAll());
+    if (!doc.isObject()) return false;
+
+    QFile bf(imagePath(key));
+    if (!bf.open(QIODevice::ReadOnly) || bf.size() != imageSize) return false;
+    QByteArray bytes = bf.readAll();
+    if (bytes.size() != imageSize) return false;
+
+    if (image) *image = std::move(bytes);
+    if (report) *report = doc.object();
+    return true;
+}
+
+bool loadImage(const QByteArray& key, char* dst, qsizetype imageSize) {
+    if (!QFileInfo::exists(reportPath(key))) return false;
+    QFile bf(imagePath(key));
+    if (!bf.open(QIODevice::ReadOnly) || bf.size() != imageSize) return false;
+    return bf.read(dst, imageSize) == imageSize;
+}
+
+bool store(const QByteArray& key, const QByteArray& image, const QJsonObject& report) {
+    if (!QDir().mkpath(directory())) return false;
+    if (!writeAtomically(imagePath(key), image)) return false;
+    if (!writeAtomically(reportPath(key), QJsonDocument(report).toJson(QJsonDocument::Compact)))
+        return false;
+    prune();
+    return true;
+}
+
+} // namespace CompositionCache
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/* ---------------------------------------------------------------------------
+   CompositionCache – composed bank images on disk, addressed by content.
+
+   The same parts in the same order with the same layout options always
+   compose to the same bank, so a finished image is stored under
+   sha256(options | part digests…) in the application cache directory,
+   together with a JSON report (layout, preflight issues).  Entries are
+   immutable: a key never changes its meaning, so there is no invalidation,
+   only pruning of the least recently stored entries.
+
+   Safe to call from worker threads; entries are written atomically
+   (QSaveFile), the report last, so a report on disk means a complete entry.
+   ----------------------------------------------------------------------- */
+namespace CompositionCache {
+
+// Oldest entries beyond this count are removed on store().
+static constexpr int MAX_ENTRIES = 64;
+
+QByteArray key(const QVector<QByteArray>& partDigests, const QByteArray& options);
+
+QString directory();
+QString imagePath(const QByteArray& key);
+
+// Whole entry; false on a miss or when the stored image is not `imageSize`
+// bytes.
+bool load(const QByteArray& key, qsizetype imageSize, QByteArray* image, QJsonObject* report);
+
+// Image only, straight into `dst` (imageSize bytes).
+bool loadImage(const QByteArray& key, char* dst, qsizetype imageSize);
+
+bool store(const QByteArray& key, const QByteArray& image, const QJsonObject& report);
+
+} // namespace CompositionCache
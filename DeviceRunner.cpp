@@ -0,0 +1,192 @@
+#include "DeviceRunner.h"
+
+#include <QProcessEnvironment>
+
+DeviceRunner::DeviceRunner(const QString& device, QObject* parent)
+    : QObject(parent), m_device(device) {
+    // Watchdog: EINMAL verbinden (keine unique-connection-Warnung)
+    m_watchdog = new QTimer(this);
+    m_watchdog->setSingleShot(true);
+    connect(m_watchdog, &QTimer::timeout, this, &DeviceRunner::onWatchdogTimeout);
+}
+
+void DeviceRunner::setProgress(int percent) {
+    percent = qBound(0, percent, 100);
+    if (percent == m_progress) return;
+    m_progress = percent;
+    emit progressChanged(percent);
+}
+
+void DeviceRunner::setStatus(Status s) {
+    m_status = s;
+    emit statusChanged();
+}
+
+void DeviceRunner::consume(const QString& chunk) {
+    QString data = chunk;
+    data.replace("\r\n", "\n");
+    const QStringList lines = data.split('\n', Qt::KeepEmptyParts);
+
+    for (const QString& rawLine : lines) {
+        QString line = rawLine;
+        int cr = line.lastIndexOf('\r');
+        if (cr >= 0) line = line.mid(cr + 1);
+
+        // Prozent erkennen, Fortschritt melden, Log nicht fluten
+        auto m = m_rePercent.match(line);
+        if (m.hasMatch()) {
+            bool ok=false; int val = line.left(line.size()-1).toInt(&ok);
+            if (ok) setProgress(val);
+            m_prevWasBlank = false;
+            continue;
+        }
+
+        const bool isBlank = line.trimmed().isEmpty();
+        if (isBlank) {
+            if (m_prevWasBlank) continue;
+            m_prevWasBlank = true;
+        } else {
+            m_prevWasBlank = false;
+        }
+        emit output(line);
+    }
+}
+
+void DeviceRunner::enqueue(const Cmd& c) {
+    m_queue.enqueue(c);
+    if (!m_running) runNext();
+    else emit statusChanged();   // pending count changed
+}
+
+void DeviceRunner::abort(const QString& why) {
+    if (!isBusy()) return;
+    m_watchdog->stop();
+    emit output(QString("%1. Killing process and clearing queue.").arg(why));
+    m_queue.clear();
+    m_running = false;
+    m_payload.reset();   // a killed child keeps its own open description
+    if (m_proc && m_proc->state() != QProcess::NotRunning) {
+        m_proc->disconnect(this);   // its late finished() must not end the next command
+        m_proc->kill();
+    }
+    m_prevWasBlank = false;
+    setProgress(0);
+    setStatus(Status::Failed);
+    emit queueFinished(false);
+}
+
+void DeviceRunner::onWatchdogTimeout() {
+    abort("Watchdog: Timed out");
+}
+
+void DeviceRunner::onProcReadyRead() {
+    if (!m_proc) return;
+    const QString out = QString::fromUtf8(m_proc->readAllStandardOutput());
+    const QString err = QString::fromUtf8(m_proc->readAllStandardError());
+    if (!out.isEmpty()) consume(out);
+    if (!err.isEmpty()) consume(err);
+}
+
+void DeviceRunner::onProcError(QProcess::ProcessError e) {
+    QString why;
+    switch (e) {
+    case QProcess::FailedToStart: why = "FailedToStart (program not found or not executable)"; break;
+    case QProcess::Crashed:       why = "Crashed"; break;
+    case QProcess::Timedout:      why = "Timedout"; break;
+    case QProcess::WriteError:    why = "WriteError"; break;
+    case QProcess::ReadError:     why = "ReadError"; break;
+    default:                      why = "UnknownError"; break;
+    }
+    emit output("QProcess error: " + why + (m_proc ? " — " + m_proc->errorString() : ""));
+    // Nur FailedToStart endet ohne finished(): sonst meldet finished() das Ende.
+    if (e == QProcess::FailedToStart && m_running)
+        commandFinished(false, why);
+}
+
+// Common end of a queued command, whichever backend ran it.
+void DeviceRunner::commandFinished(bool ok, const QString& failure) {
+    if (!m_running) return;   // aborted (watchdog), already handled
+    m_watchdog->stop();
+    m_running = false;
+    m_payload.reset();
+
+    if (ok) {
+        emit output("Command completed successfully.");
+        if (m_queue.isEmpty()) {
+            m_currentLabel.clear();
+            setStatus(Status::Idle);
+            emit queueFinished(true);
+            return;
+        }
+        runNext();
+    } else {
+        emit output(QString("Command failed (%1). Aborting queue.").arg(failure));
+        m_queue.clear();
+        m_prevWasBlank = false;
+        setProgress(0);
+        setStatus(Status::Failed);
+        emit queueFinished(false);
+    }
+}
+
+void DeviceRunner::runNext() {
+    if (m_running || m_queue.isEmpty()) return;
+
+    m_running = true;
+    Cmd c = m_queue.dequeue();
+    m_currentLabel = c.label;
+    m_payload = c.payload;
+    setStatus(Status::Busy);
+
+    // Timeout-Überwachung (0 = aus) – nur Intervall + Start, kein mehrfaches connect
+    m_watchdog->stop();
+    if (c.timeoutMs > 0) {
+        m_watchdog->setInterval(c.timeoutMs);
+        m_watchdog->start();
+    }
+
+    QStringList args;
+    if (!m_device.isEmpty()) args << "-d" << m_device;
+    args << c.args;
+
+    if (m_proc) { m_proc->disconnect(this); m_proc->deleteLater(); m_proc = nullptr; }
+    m_proc = new QProcess(this);
+    connect(m_proc, &QProcess::readyReadStandardOutput, this, &DeviceRunner::onProcReadyRead);
+    connect(m_proc, &QProcess::readyReadStandardError,  this, &DeviceRunner::onProcReadyRead);
+    connect(m_proc, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished),
+            this, [this](int code, QProcess::ExitStatus st) {
+        commandFinished(st == QProcess::NormalExit && code == 0,
+                        QString("exit=%1, status=%2").arg(code).arg(st == QProcess::NormalExit ? "Normal" : "Crashed"));
+    });
+    connect(m_proc, &QProcess::errorOccurred, this, &DeviceRunner::onProcError);
+    connect(m_proc, &QProcess::started, this, [this](){
+        emit output("Process started.");
+        m_prevWasBlank = false;
+        setProgress(0);
+    });
+
+    if (c.log) emit output("$ " + c.program + " " + args.join(' '));
+
+    // PATH ergänzen
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+#ifdef Q_OS_MAC
+    {
+        QString path = env.value("PATH");
+        if (!path.contains("/usr/local/bin"))    path += ":/usr/local/bin";
+        if (!path.contains("/opt/homebrew/bin")) path += ":/opt/homebrew/bin";
+        env.insert("PATH", path);
+    }
+#endif
+#ifdef Q_OS_LINUX
+    {
+        QString path = env.value("PATH");
+        if (!path.contains("/usr/local/bin")) path += ":/usr/local/bin";
+        env.insert("PATH", path);
+    }
+#endif
+    m_proc->setProcessEnvironment(env);
+
+    m_proc->setProgram(c.program);
+    m_proc->setArguments(args);
+    m_proc->start();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QObject>
+#include <QProcess>
+#include <QQueue>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include "Payload.h"
+
+/* ---------------------------------------------------------------------------
+   DeviceRunner – job queue of one programmer.
+
+   Everything that used to be MainWindow-global per command lives here, once
+   per device: the queue, the mxprog process, the watchdog and the progress
+   parsing.  Runners of different devices are independent, so several
+   programmers work in parallel.  An empty device name is the "Auto" runner:
+   mxprog picks the device.
+
+   A failed command clears the rest of this runner's queue, as before.
+   ----------------------------------------------------------------------- */
+class DeviceRunner : public QObject {
+    Q_OBJECT
+public:
+    struct Cmd {
+        QString program;              // mxprog executable
+        QStringList args;             // without -d, the runner adds it
+        bool log = true;
+        QString label;
+        int timeoutMs = 0; // 0 = kein Timeout
+        PayloadPtr payload;           // file the args refer to, kept until the command is done
+    };
+
+    enum class Status { Idle, Busy, Failed };
+
+    explicit DeviceRunner(const QString& device, QObject* parent = nullptr);
+
+    QString device() const { return m_device; }
+    Status status() const { return m_status; }
+    bool isBusy() const { return m_running || !m_queue.isEmpty(); }
+    int progress() const { return m_progress; }
+    QString currentLabel() const { return m_currentLabel; }
+    int pending() const { return m_queue.size(); }
+
+    void enqueue(const Cmd& c);
+    void abort(const QString& why);
+
+signals:
+    void output(const QString& text);          // log lines, already de-flooded
+    void progressChanged(int percent);
+    void statusChanged();
+    void queueFinished(bool ok);               // queue ran empty or was aborted
+
+private:
+    void runNext();
+    void commandFinished(bool ok, const QString& failure);
+    void onProcReadyRead();
+    void onProcError(QProcess::ProcessError e);
+    void onWatchdogTimeout();
+    void consume(const QString& chunk);
+    void setProgress(int percent);
+    void setStatus(Status s);
+
+    QString     m_device;
+    QQueue<Cmd> m_queue;
+    bool        m_running = false;
+    QString     m_currentLabel;
+    PayloadPtr  m_payload;        // of the running command
+    Status      m_status = Status::Idle;
+
+    QProcess*   m_proc = nullptr;
+    QTimer*     m_watchdog = nullptr;
+
+    int                m_progress = 0;
+    bool               m_prevWasBlank = false;
+    QRegularExpression m_rePercent{R"(^\d+%$)"};
+};
@@ -12,14 +12,24 @@
 #include <QFileInfo>
 #include <QtSerialPort/QSerialPortInfo>
 #include <QMessageBox>
-#include <QProcessEnvironment>
 #include <QFontDatabase>
 #include <QTextOption>
 #include <QStatusBar>
+#include <QSet>
+#include <QHeaderView>
+#include <QCryptographicHash>
+#include <QtConcurrent/QtConcurrentRun>
+#include <cstring>
 
 static const int SLOT_SIZE   = 512 * 1024;
 static const int TOTAL_BYTES = 2048 * 1024;
 
+static QString bankList(const QList<int>& banks) {
+    QStringList out;
+    for (int b : banks) out << QString::number(b);
+    return out.join(", ");
+}
+
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     m_central = new QWidget(this);
     setCentralWidget(m_central);
@@ -120,7 +130,29 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     devBox->addWidget(btnRead);
     devBox->addWidget(btnTerm);
     devBox->addStretch();
+    auto* btnFleet = new QPushButton("Program Fleet (monolithic)", this);
+    btnFleet->setToolTip("Erase/write/verify the composed 2 MiB image on every checked programmer in parallel.");
+    devBox->addWidget(btnFleet);
     v->addLayout(devBox);
+    connect(btnFleet, &QPushButton::clicked, this, &MainWindow::programFleet);
+
+    // Fleet view: every detected programmer, its queue state and progress.
+    m_fleetTable = new QTableWidget(0, 5, this);
+    m_fleetTable->setHorizontalHeaderLabels({ "Use", "Device", "Status", "Progress", "Chips" });
+    m_fleetTable->verticalHeader()->setVisible(false);
+    m_fleetTable->horizontalHeader()->setStretchLastSection(false);
+    m_fleetTable->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
+    m_fleetTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_fleetTable->setSelectionMode(QAbstractItemView::NoSelection);
+    m_fleetTable->setMaximumHeight(140);
+    v->addWidget(m_fleetTable);
+    refreshDevices();
+
+    // Bank writes settle briefly so back-to-back clicks end up in one batch.
+    m_coalesceTimer = new QTimer(this);
+    m_coalesceTimer->setSingleShot(true);
+    m_coalesceTimer->setInterval(300);
+    connect(m_coalesceTimer, &QTimer::timeout, this, &MainWindow::flushIdleWrites);
 
     connect(btnIdentify, &QPushButton::clicked, this, &MainWindow::identify);
     connect(btnErase,    &QPushButton::clicked, this, &MainWindow::erase);
@@ -142,10 +174,15 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     m_progBar->setValue(0);
     statusBar()->addPermanentWidget(m_progBar, 0);
 
-    // Watchdog: EINMAL verbinden (keine unique-connection-Warnung)
-    m_watchdog = new QTimer(this);
-    m_watchdog->setSingleShot(true);
-    connect(m_watchdog, &QTimer::timeout, this, &MainWindow::onWatchdogTimeout);
+    // The status bar follows the programmer picked in the device box, and
+    // so does the target of the next Write Slot click.
+    auto followDevice = [this]() {
+        const DeviceRunner* r = m_runners.value(selectedDevice());
+        m_progBar->setValue(r ? r->progress() : 0);
+        for (auto* b : m_banks) b->setWriteTarget(selectedDevice());
+    };
+    connect(m_deviceCombo, &QComboBox::currentTextChanged, this, followDevice);
+    followDevice();
 }
 
 void MainWindow::refreshDevices() {
@@ -175,12 +212,110 @@ void MainWindow::refreshDevices() {
         }
     }
 #endif
+
+    // Fleet rows: detected devices plus any that still have a runner; the
+    // "Use" choice survives a refresh.
+    if (!m_fleetTable) return;
+    QSet<QString> checked;
+    for (int r = 0; r < m_fleetTable->rowCount(); ++r) {
+        if (m_fleetTable->item(r, 0)->checkState() == Qt::Checked)
+            checked.insert(m_fleetTable->item(r, 1)->text());
+    }
+    QStringList devices;
+    for (int i = 1; i < m_deviceCombo->count(); ++i) devices << m_deviceCombo->itemText(i);
+    for (auto it = m_runners.constBegin(); it != m_runners.constEnd(); ++it) {
+        if (!it.key().isEmpty() && !devices.contains(it.key())) devices << it.key();
+    }
+
+    m_fleetTable->setRowCount(0);
+    for (const auto& dev : devices) {
+        const int r = m_fleetTable->rowCount();
+        m_fleetTable->insertRow(r);
+        auto* use = new QTableWidgetItem();
+        use->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled);
+        use->setCheckState(checked.contains(dev) ? Qt::Checked : Qt::Unchecked);
+        m_fleetTable->setItem(r, 0, use);
+        m_fleetTable->setItem(r, 1, new QTableWidgetItem(dev));
+        m_fleetTable->setItem(r, 2, new QTableWidgetItem());
+        auto* bar = new QProgressBar(m_fleetTable);
+        bar->setRange(0, 100);
+        m_fleetTable->setCellWidget(r, 3, bar);
+        m_fleetTable->setItem(r, 4, new QTableWidgetItem());
+        updateFleetRow(dev);
+    }
 }
 
-QString MainWindow::selectedDeviceArg() const {
+QString MainWindow::selectedDevice() const {
     QString dev = m_deviceCombo->currentText();
     if (dev.startsWith("Auto")) return QString();
-    return QStringList{"-d", dev}.join(' ');
+    return dev;
+}
+
+DeviceRunner* MainWindow::runnerFor(const QString& device) {
+    if (DeviceRunner* r = m_runners.value(device)) return r;
+
+    auto* r = new DeviceRunner(device, this);
+    m_runners.insert(device, r);
+    // Several programmers log into one view: tag their lines.
+    const QString tag = device.isEmpty() ? QString() : QString("[%1] ").arg(QFileInfo(device).fileName());
+    connect(r, &DeviceRunner::output, this, [this, tag](const QString& line) {
+        m_log->appendPlainText(tag + line);
+        m_log->ensureCursorVisible();
+    });
+    connect(r, &DeviceRunner::progressChanged, this, [this, device](int pct) {
+        if (device == selectedDevice()) m_progBar->setValue(pct);
+        updateFleetRow(device);
+    });
+    connect(r, &DeviceRunner::statusChanged, this, [this, device]() { updateFleetRow(device); });
+    connect(r, &DeviceRunner::queueFinished, this, [this, device](bool ok) {
+        if (!ok) {
+            // Chip content unknown after a failure; don't build on it.
+            m_onChip.remove(device);
+            m_prepared.remove(device);
+            if (m_pendingWrites.contains(device)) {
+                m_log->appendPlainText(QString("Dropped pending writes of bank(s) %1 after the failure; "
+                                               "write them again.")
+                                       .arg(bankList(m_pendingWrites.take(device).keys())));
+            }
+        } else {
+            flushWrites(device);
+        }
+    });
+    connect(r, &DeviceRunner::queueFinished, this, [this, device](bool ok) {
+        const auto started = m_fleetStarted.constFind(device);
+        if (started == m_fleetStarted.constEnd()) return;   // not a fleet job
+        const qint64 secs = (QDateTime::currentMSecsSinceEpoch() - started.value()) / 1000;
+        m_fleetStarted.remove(device);
+        if (ok) ++m_fleetDone[device];
+        m_log->appendPlainText(QString("Fleet: %1 %2 after %3 s.")
+                               .arg(device, ok ? "done" : "FAILED").arg(secs));
+        updateFleetRow(device);
+    });
+    return r;
+}
+
+void MainWindow::updateFleetRow(const QString& device) {
+    if (!m_fleetTable || device.isEmpty()) return;
+    for (int row = 0; row < m_fleetTable->rowCount(); ++row) {
+        if (m_fleetTable->item(row, 1)->text() != device) continue;
+        const DeviceRunner* r = m_runners.value(device);
+        QString status = "Idle";
+        if (r) {
+            switch (r->status()) {
+            case DeviceRunner::Status::Idle:   status = "Idle"; break;
+            case DeviceRunner::Status::Failed: status = "Failed"; break;
+            case DeviceRunner::Status::Busy:
+                status = QString("Busy: %1").arg(r->currentLabel());
+                if (r->pending() > 0) status += QString(" (+%1 queued)").arg(r->pending());
+                break;
+            }
+        }
+        m_fleetTable->item(row, 2)->setText(status);
+        if (auto* bar = qobject_cast<QProgressBar*>(m_fleetTable->cellWidget(row, 3)))
+            bar->setValue(r ? r->progress() : 0);
+        m_fleetTable->item(row, 4)->setText(QString::number(m_fleetDone.value(device)));
+        return;
+    }
 }
 
 QString MainWindow::discoverMxprog() const {
@@ -214,203 +349,225 @@ QString MainWindow::mxprogPath() const {
     return p.isEmpty() ? "mxprog" : p;
 }
 
-void MainWindow::resetProgressTracking() {
-    m_progressBlock = -1;
-    m_prevWasBlank  = false;
-    if (m_progBar) m_progBar->setValue(0);
+void MainWindow::enqueue(const QStringList& args, const QString& label, bool log, int timeoutMs) {
+    DeviceRunner::Cmd c;
+    c.program = mxprogPath(); c.args = args; c.log = log; c.label = label; c.timeoutMs = timeoutMs;
+    runnerFor(selectedDevice())->enqueue(c);
 }
 
-void MainWindow::appendSmart(const QString& chunk) {
-    QString data = chunk;
-    data.replace("\r\n", "\n");
-    const QStringList lines = data.split('\n', Qt::KeepEmptyParts);
-
-    for (const QString& rawLine : lines) {
-        QString line = rawLine;
-        int cr = line.lastIndexOf('\r');
-        if (cr >= 0) line = line.mid(cr + 1);
-
-        // Prozent erkennen, Statusbar updaten, Log nicht fluten
-        auto m = m_rePercent.match(line);
-        if (m.hasMatch()) {
-            bool ok=false; int val = line.left(line.size()-1).toInt(&ok);
-            if (ok && m_progBar) m_progBar->setValue(qBound(0, val, 100));
-            m_prevWasBlank = false;
-            continue;
-        }
-
-        const bool isBlank = line.trimmed().isEmpty();
-        if (isBlank) {
-            if (m_prevWasBlank) continue;
-            m_prevWasBlank = true;
-        } else {
-            m_prevWasBlank = false;
-        }
-        m_log->appendPlainText(line);
-    }
-    m_log->ensureCursorVisible();
+QByteArray MainWindow::buildMonolithic2MiB() const {
+    // One allocation; every bank composes straight into its 512 KiB window.
+    QByteArray out(TOTAL_BYTES, Qt::Uninitialized);
+    const int banks = qMin(int(m_banks.size()), TOTAL_BYTES / BankWidget::SLOT_SIZE);
+    BankWidget::composeBanks(m_banks.mid(0, banks), out.data());
+    const int used = banks * BankWidget::SLOT_SIZE;
+    std::memset(out.data() + used, 0xff, TOTAL_BYTES - used);
+    return out;
 }
 
-void MainWindow::onProcReadyRead() {
-    if (!m_proc) return;
-    const QString out = QString::fromUtf8(m_proc->readAllStandardOutput());
-    const QString err = QString::fromUtf8(m_proc->readAllStandardError());
-    if (!out.isEmpty()) appendSmart(out);
-    if (!err.isEmpty()) appendSmart(err);
+QString MainWindow::timestampedDumpName() const {
+    return QString("romdump_%1.bin").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
 }
 
-void MainWindow::onProcFinished(int code, QProcess::ExitStatus st) {
-    m_watchdog->stop();
+// ---------- Actions ----------
 
-    if (st == QProcess::NormalExit && code == 0) {
-        m_log->appendPlainText("Command completed successfully.");
-        m_running = false;
-        runNext();
-    } else {
-        m_log->appendPlainText(QString("Command failed (exit=%1, status=%2). Aborting queue.")
-                               .arg(code).arg(st == QProcess::NormalExit ? "Normal" : "Crashed"));
-        m_queue.clear();
-        m_running = false;
-        resetProgressTracking();
+/* ---------------------------------------------------------------------------
+   Bank writes – coalesced per device.
+
+   writeSlot only records the bank image; the device's writes are issued
+   once its runner is idle (after a short settle delay for back-to-back
+   clicks).  Everything pending by then goes out as one batch:
+
+     - at most one chip erase,
+     - one write + one verify per bank (-b N), or a single monolithic
+       pass without -b when the batch covers all four banks.
+
+   Partial runs are not merged into one -b write: how far mxprog writes
+   past the bank given with -b is not established, and a short write
+   would pass its equally short verify while the erase took the rest.
+
+   With erase on, banks this session already put on the chip since its last
+   erase are rewritten from their images in the same batch, so the erase
+   for bank N no longer wipes bank N-1 written a moment earlier.
+   ----------------------------------------------------------------------- */
+void MainWindow::writeSlot(int bank, const QByteArray& img512k, const QString& device, quint64 sequence) {
+    // A later click of this bank was prepared first: this image is older.
+    auto& newest = m_writeSequence[device][bank];
+    if (sequence < newest) {
+        m_log->appendPlainText(QString("Bank %1: dropped an image older than the one already taken.").arg(bank));
+        return;
     }
+    newest = sequence;
+
+    auto& pending = m_pendingWrites[device];
+    if (pending.contains(bank))
+        m_log->appendPlainText(QString("Bank %1: replaces the write still pending.").arg(bank));
+    pending.insert(bank, img512k);
+
+    const DeviceRunner* r = m_runners.value(device);
+    if (r && r->isBusy()) {
+        m_log->appendPlainText(QString("Bank %1: queued, written together with other pending banks "
+                                       "when the current job ends.").arg(bank));
+        prepareAhead(device);
+    }
+    m_coalesceTimer->start();
 }
 
-void MainWindow::onProcError(QProcess::ProcessError e) {
-    QString why;
-    switch (e) {
-    case QProcess::FailedToStart: why = "FailedToStart (program not found or not executable)"; break;
-    case QProcess::Crashed:       why = "Crashed"; break;
-    case QProcess::Timedout:      why = "Timedout"; break;
-    case QProcess::WriteError:    why = "WriteError"; break;
-    case QProcess::ReadError:     why = "ReadError"; break;
-    default:                      why = "UnknownError"; break;
-    }
-    m_log->appendPlainText("QProcess error: " + why + (m_proc ? " — " + m_proc->errorString() : ""));
-    // Weiter zur nächsten Queue-Aufgabe (oder hier abbrechen)
-    m_running = false;
-    runNext();
-}
-
-void MainWindow::onWatchdogTimeout() {
-    m_log->appendPlainText("Watchdog: Timed out. Killing process and clearing queue.");
-    if (m_proc && m_proc->state() != QProcess::NotRunning) {
-        m_proc->kill();
+void MainWindow::flushIdleWrites() {
+    const QStringList devices = m_pendingWrites.keys();
+    for (const auto& dev : devices) {
+        const DeviceRunner* r = m_runners.value(dev);
+        if (!r || !r->isBusy()) flushWrites(dev);   // busy: queueFinished flushes
     }
-    m_queue.clear();
-    m_running = false;
-    resetProgressTracking();
 }
 
-void MainWindow::enqueue(const QStringList& args, const QString& label, bool log, int timeoutMs) {
-    QStringList realArgs;
-    QString devArg = selectedDeviceArg();
-    if (!devArg.isEmpty()) {
-        auto parts = devArg.split(' ');
-        realArgs << parts; // "-d" "<device>"
+// What the chip must hold after the device's next batch: an erase takes the
+// banks written earlier with it, so they ride along.
+QMap<int, QByteArray> MainWindow::batchBanks(const QString& device) const {
+    QMap<int, QByteArray> banks = m_pendingWrites.value(device);
+    if (m_chkErase->isChecked()) {
+        const QMap<int, QByteArray> onChip = m_onChip.value(device);
+        for (auto it = onChip.constBegin(); it != onChip.constEnd(); ++it)
+            if (!banks.contains(it.key())) banks.insert(it.key(), it.value());
     }
-    realArgs << args;
-
-    Cmd c; c.args = realArgs; c.log = log; c.label = label; c.timeoutMs = timeoutMs;
-    m_queue.enqueue(c);
-
-    if (!m_running) runNext();
+    return banks;
 }
 
-void MainWindow::runNext() {
-    if (m_running || m_queue.isEmpty()) return;
-
-    m_running = true;
-    Cmd c = m_queue.dequeue();
-
-    if (m_proc) { m_proc->deleteLater(); m_proc = nullptr; }
-    m_proc = new QProcess(this);
-    connect(m_proc, &QProcess::readyReadStandardOutput, this, &MainWindow::onProcReadyRead);
-    connect(m_proc, &QProcess::readyReadStandardError,  this, &MainWindow::onProcReadyRead);
-    connect(m_proc, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &MainWindow::onProcFinished);
-    connect(m_proc, &QProcess::errorOccurred, this, &MainWindow::onProcError);
-    connect(m_proc, &QProcess::started, this, [this](){
-        m_log->appendPlainText("Process started.");
-        resetProgressTracking();
-    });
-
-    const QString prog = mxprogPath();
-    if (c.log) m_log->appendPlainText("$ " + prog + " " + c.args.join(' '));
-
-    // PATH ergänzen 
-    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-#ifdef Q_OS_MAC
-    {
-        QString path = env.value("PATH");
-        if (!path.contains("/usr/local/bin"))    path += ":/usr/local/bin";
-        if (!path.contains("/opt/homebrew/bin")) path += ":/opt/homebrew/bin";
-        env.insert("PATH", path);
-    }
-#endif
-#ifdef Q_OS_LINUX
-    {
-        QString path = env.value("PATH");
-        if (!path.contains("/usr/local/bin")) path += ":/usr/local/bin";
-        env.insert("PATH", path);
+/* ---------------------------------------------------------------------------
+   prepareBatch – host side of a batch, worker-safe: one run per bank, or
+   one whole-chip run when every bank is in it, with their SHA-256 and, for
+   mxprog, one immutable payload per run.
+   ----------------------------------------------------------------------- */
+MainWindow::WriteBatch MainWindow::prepareBatch(const QMap<int, QByteArray>& banks) {
+    WriteBatch b;
+    b.banks = banks;
+    const bool wholeChip = banks.size() * SLOT_SIZE == TOTAL_BYTES;   // keys are 0..3
+    for (auto it = banks.constBegin(); it != banks.constEnd(); ++it) {
+        if (wholeChip && !b.runs.isEmpty()) {
+            b.runs.last().data += it.value();
+            ++b.runs.last().count;
+        } else {
+            b.runs.push_back({ it.key(), 1, it.value(), QByteArray(), nullptr });
+        }
     }
-#endif
-    m_proc->setProcessEnvironment(env);
-
-    m_proc->setProgram(prog);
-    m_proc->setArguments(c.args);
-    m_proc->start();
 
-    // Timeout-Überwachung (0 = aus) – nur Intervall + Start, kein mehrfaches connect
-    m_watchdog->stop();
-    if (c.timeoutMs > 0) {
-        m_watchdog->setInterval(c.timeoutMs);
-        m_watchdog->start();
+    for (auto& run : b.runs) {
+        run.sha256 = QCryptographicHash::hash(run.data, QCryptographicHash::Sha256);
+        const QString name = (run.count == 1) ? QString("slot%1_512k").arg(run.first)
+                                              : QString("banks_all_2048k");
+        QString error;
+        run.payload = Payload::create(run.data, name, &error);
+        if (!run.payload) {
+            b.error = QString("Payload for %1 failed: %2").arg(name, error);
+            return b;
+        }
     }
+    return b;
 }
 
-QByteArray MainWindow::buildMonolithic2MiB() const {
-    QByteArray out; out.reserve(TOTAL_BYTES);
-    for (auto* b : m_banks) out.append(b->buildTiled512k());
-    if (out.size() < TOTAL_BYTES) out.append(QByteArray(TOTAL_BYTES - out.size(), char(0xff)));
-    return out.left(TOTAL_BYTES);
+// While the device is busy, the pending batch is prepared on a worker so the
+// next erase/write can be queued the moment the current job ends.
+void MainWindow::prepareAhead(const QString& device) {
+    if (auto* old = m_preparing.take(device)) {
+        old->disconnect(this);
+        if (old->isFinished()) old->deleteLater();
+        else connect(old, &QFutureWatcher<WriteBatch>::finished, old, &QObject::deleteLater);
+    }
+    m_prepared.remove(device);
+
+    auto* watcher = new QFutureWatcher<WriteBatch>(this);
+    m_preparing.insert(device, watcher);
+    connect(watcher, &QFutureWatcher<WriteBatch>::finished, this, [this, device, watcher]() {
+        m_preparing.remove(device);
+        m_prepared.insert(device, watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&MainWindow::prepareBatch, batchBanks(device)));
 }
 
-QString MainWindow::timestampedDumpName() const {
-    return QString("romdump_%1.bin").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
-}
+void MainWindow::flushWrites(const QString& device) {
+    if (!m_pendingWrites.contains(device)) return;
+    const QMap<int, QByteArray> banks = batchBanks(device);
+    const QMap<int, QByteArray> pending = m_pendingWrites.take(device);
 
-// ---------- Actions ----------
+    DeviceRunner* runner = runnerFor(device);
+    const bool erase = m_chkErase->isChecked();
 
-void MainWindow::writeSlot(int bank, const QByteArray& img512k) {
-    // Tempfile
-    QString tmpPath = QDir::temp().filePath(QString("slot%1_512k.bin").arg(bank));
-    QFile f(tmpPath);
-    if (!f.open(QIODevice::WriteOnly)) {
-        m_log->appendPlainText("Temp file creation failed: " + tmpPath);
+    // Prepared ahead, unless the chip state changed since.
+    if (auto* w = m_preparing.take(device)) {
+        w->disconnect(this);
+        w->waitForFinished();
+        m_prepared.insert(device, w->result());
+        w->deleteLater();
+    }
+    WriteBatch batch = m_prepared.take(device);
+    if (batch.banks != banks || !batch.error.isEmpty())
+        batch = prepareBatch(banks);
+    // Payloads all exist before anything is queued: a failure must not
+    // leave a lone erase behind.
+    if (!batch.error.isEmpty()) {
+        m_log->appendPlainText(batch.error);
+        m_onChip.remove(device);   // don't know what the chip holds any more
         return;
     }
-    f.write(img512k);
-    f.close();
 
-    // Beispiel-Timeouts / Passt bei mir
+    auto& onChip = m_onChip[device];
+    if (erase) {
+        onChip = banks;
+    } else {
+        for (auto it = pending.constBegin(); it != pending.constEnd(); ++it)
+            onChip.insert(it.key(), it.value());
+    }
+
+    QStringList names;
+    for (auto it = banks.constBegin(); it != banks.constEnd(); ++it)
+        names << (pending.contains(it.key()) ? QString::number(it.key())
+                                             : QString("%1 (rewrite)").arg(it.key()));
+    if (banks.size() > 1)
+        m_log->appendPlainText(QString("Coalesced bank writes %1 into one batch.").arg(names.join(", ")));
+
+    // Beispiel-Timeouts / Passt bei mir (write/verify per 512 KiB bank)
     const int tEraseMs  =  90'000;
     const int tWriteMs  = 240'000;
     const int tVerifyMs = 120'000;
 
-    if (m_chkErase->isChecked()) {
-        enqueue(QStringList() << "-y" << "-e", "erase", true, tEraseMs);
-    }
-    enqueue(QStringList() << "-b" << QString::number(bank) << "-w" << tmpPath, "write", true, tWriteMs);
-    if (m_chkVerify->isChecked()) {
-        enqueue(QStringList() << "-b" << QString::number(bank) << "-v" << tmpPath, "verify", true, tVerifyMs);
+    if (erase)
+        enqueueOn(runner, "erase", tEraseMs, QStringList() << "-y" << "-e");
+    for (const auto& run : batch.runs) {
+        QStringList target;
+        QString what;
+        if (run.count * SLOT_SIZE == TOTAL_BYTES) {
+            what = "all";                       // ohne -b (Alle Bänke ab Adresse 0)
+        } else {
+            target << "-b" << QString::number(run.first);
+            what = QString::number(run.first);
+        }
+        const QString path = run.payload->path();
+        m_log->appendPlainText(QString("Write %1: %2 bytes, sha256=%3…%4")
+                               .arg(what).arg(run.data.size())
+                               .arg(QString::fromLatin1(run.sha256.toHex().left(16)))
+                               .arg(run.payload->inMemory() ? QString(" (memfd)") : " from " + path));
+        enqueueOn(runner, "write " + what, tWriteMs * run.count,
+                  QStringList(target) << "-w" << path, run.payload);
+        if (m_chkVerify->isChecked())
+            enqueueOn(runner, "verify " + what, tVerifyMs * run.count,
+                      QStringList(target) << "-v" << path, run.payload);
     }
 }
 
-void MainWindow::writeAllMonolithic() {
-    QByteArray blob = buildMonolithic2MiB();
+void MainWindow::enqueueOn(DeviceRunner* runner, const QString& label, int timeoutMs,
+                           const QStringList& args, const PayloadPtr& payload) {
+    DeviceRunner::Cmd c;
+    c.program = mxprogPath(); c.label = label; c.timeoutMs = timeoutMs;
+    c.args = args; c.payload = payload;
+    runner->enqueue(c);
+}
 
+// Keep a copy of the 2 MiB buffer that goes to the device (Documents, else
+// temp).  Only a record: programming reads its own payload.
+void MainWindow::keepCopy(const QByteArray& blob) {
     const QString docs = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
-    QString path = QDir(docs.isEmpty() ? QDir::homePath() : docs).filePath(timestampedDumpName());
+    const QString path = QDir(docs.isEmpty() ? QDir::homePath() : docs).filePath(timestampedDumpName());
 
     auto trySave = [&](const QString& p)->bool{
         QFile f(p);
@@ -421,39 +578,93 @@ void MainWindow::writeAllMonolithic() {
         return true;
     };
 
-    bool saved = trySave(path);
-    if (!saved) {
-        const QString tmp = QDir::temp().filePath(timestampedDumpName());
-        if (trySave(tmp)) {
-            path = tmp; saved = true;
-            m_log->appendPlainText("Primary save failed, used temp path instead.");
-        } else {
-            m_log->appendPlainText("Save failed in Documents and Temp. Will program from a temp path without persisting.");
-            QString hardTmp = QDir::temp().filePath("romdump_fallback.bin");
-            QFile f(hardTmp);
-            if (f.open(QIODevice::WriteOnly)) {
-                f.write(blob); f.close();
-                path = hardTmp; saved = true;
-            } else {
-                QMessageBox::critical(this, "Save failed", "Could not create any buffer file for programming.");
-                return;
-            }
-        }
+    if (trySave(path)) return;
+    if (trySave(QDir::temp().filePath(timestampedDumpName()))) {
+        m_log->appendPlainText("Primary save failed, used temp path instead.");
+        return;
     }
+    m_log->appendPlainText("Save failed in Documents and Temp; programming without a copy.");
+}
 
+// Erase (optional), write and verify (optional) of the whole device on one
+// runner.  The payload is immutable and shared between runners.
+void MainWindow::enqueueMonolithic(DeviceRunner* runner, const QByteArray& blob, const PayloadPtr& payload) {
     // Beispiel-Timeouts s.o
     const int tEraseMs  = 120'000;
     const int tWriteMs  = 300'000;
     const int tVerifyMs = 180'000;
 
-    if (m_chkErase->isChecked()) {
-        enqueue(QStringList() << "-y" << "-e", "erase", true, tEraseMs);
-    }
+    const QString path = payload->path();
+
+    if (m_chkErase->isChecked())
+        enqueueOn(runner, "erase", tEraseMs, QStringList() << "-y" << "-e");
     // ohne -b (Alle Bänke ab Adresse 0)
-    enqueue(QStringList() << "-w" << path, "write-all", true, tWriteMs);
-    if (m_chkVerify->isChecked()) {
-        enqueue(QStringList() << "-v" << path, "verify-all", true, tVerifyMs);
+    enqueueOn(runner, "write-all", tWriteMs, QStringList() << "-w" << path, payload);
+    if (m_chkVerify->isChecked())
+        enqueueOn(runner, "verify-all", tVerifyMs, QStringList() << "-v" << path, payload);
+
+    // The chip now holds exactly this image; per-bank batches rewrite from it
+    // after their erase.
+    auto& onChip = m_onChip[runner->device()];
+    onChip.clear();
+    for (int b = 0; b < TOTAL_BYTES / SLOT_SIZE; ++b)
+        onChip.insert(b, blob.mid(b * SLOT_SIZE, SLOT_SIZE));
+}
+
+PayloadPtr MainWindow::monolithicPayload(const QByteArray& blob) {
+    QString error;
+    PayloadPtr payload = Payload::create(blob, "romdump_2048k", &error);
+    if (!payload) {
+        m_log->appendPlainText("Payload creation failed: " + error);
+        QMessageBox::critical(this, "Payload failed", "Could not hand the buffer to mxprog:\n" + error);
+    }
+    return payload;
+}
+
+void MainWindow::writeAllMonolithic() {
+    QByteArray blob = buildMonolithic2MiB();
+    keepCopy(blob);
+
+    const PayloadPtr payload = monolithicPayload(blob);
+    if (!payload) return;
+    enqueueMonolithic(runnerFor(selectedDevice()), blob, payload);
+}
+
+/* ---------------------------------------------------------------------------
+   programFleet – the same composed image onto every checked programmer.
+   The image is composed and saved once; each device then runs its own
+   erase/write/verify queue, all in parallel.  Devices still busy with a
+   previous job are skipped.
+   ----------------------------------------------------------------------- */
+void MainWindow::programFleet() {
+    QStringList devices;
+    for (int r = 0; r < m_fleetTable->rowCount(); ++r) {
+        if (m_fleetTable->item(r, 0)->checkState() == Qt::Checked)
+            devices << m_fleetTable->item(r, 1)->text();
+    }
+    if (devices.isEmpty()) {
+        QMessageBox::information(this, "Program Fleet", "Check the programmers to use in the fleet table first.");
+        return;
     }
+
+    const QByteArray blob = buildMonolithic2MiB();
+    keepCopy(blob);
+    // One payload for the whole fleet.
+    const PayloadPtr payload = monolithicPayload(blob);
+    if (!payload) return;
+
+    int started = 0;
+    for (const auto& dev : devices) {
+        DeviceRunner* runner = runnerFor(dev);
+        if (runner->isBusy()) {
+            m_log->appendPlainText(QString("Fleet: %1 is busy, skipped.").arg(dev));
+            continue;
+        }
+        m_fleetStarted.insert(dev, QDateTime::currentMSecsSinceEpoch());
+        enqueueMonolithic(runner, blob, payload);
+        ++started;
+    }
+    m_log->appendPlainText(QString("Fleet: programming %1 device(s) in parallel.").arg(started));
 }
 
 void MainWindow::saveMonolithic() {
@@ -476,8 +687,13 @@ void MainWindow::saveMonolithic() {
     m_log->appendPlainText("Saved 2 MiB buffer to: " + path);
 }
 
-void MainWindow::identify() { enqueue(QStringList() << "-i", "identify", true, 15'000); }
-void MainWindow::erase()     { enqueue(QStringList() << "-y" << "-e", "erase", true, 120'000); }
+void MainWindow::identify() {
+    enqueue(QStringList() << "-i", "identify", true, 15'000);
+}
+void MainWindow::erase() {
+    m_onChip.remove(selectedDevice());
+    enqueue(QStringList() << "-y" << "-e", "erase", true, 120'000);
+}
 void MainWindow::readDump() {
     QString path = QFileDialog::getSaveFileName(this, "Read EEPROM to file", "eeprom_dump.bin",
                                                 "Binary (*.bin);;All (*.*)");
@@ -501,17 +717,18 @@ void MainWindow::importRomAndCatalog() {
         return;
     }
 
-    const auto slices = RomTools::splitIntoBanks(meta.padded2MiB);
+    auto slices = RomTools::splitIntoBanks(meta.padded2MiB);
     if (slices.size() != 4) {
         QMessageBox::warning(this, "Split failed", "Could not split ROM into 4 banks.");
         return;
     }
 
     QStringList componentWarnings;
-    const auto components = RomTools::extractComponents(meta.canonicalData, &componentWarnings);
+    auto components = RomTools::extractComponents(meta.canonicalData, &componentWarnings);
     for (const auto& w : componentWarnings) {
         meta.warnings << w;
     }
+    RomTools::computeDigests(meta, slices, components);
 
     const QString baseName = QFileInfo(source).completeBaseName();
     const QString defDir = QDir(QFileInfo(source).absolutePath()).filePath(baseName + "_catalog");
@@ -3,16 +3,19 @@
 #include <QPlainTextEdit>
 #include <QComboBox>
 #include <QCheckBox>
-#include <QProcess>
 #include <QScrollArea>
 #include <QLineEdit>
 #include <QSettings>
-#include <QQueue>
-#include <QRegularExpression>
+#include <QMap>
+#include <QHash>
 #include <QProgressBar>
+#include <QTableWidget>
 #include <QTimer>
+#include <QFutureWatcher>
 
 #include "BankWidget.h"
+#include "DeviceRunner.h"
+#include "Payload.h"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -20,7 +23,7 @@ public:
     explicit MainWindow(QWidget* parent=nullptr);
 
 private slots:
-    void writeSlot(int bank, const QByteArray& img512k);
+    void writeSlot(int bank, const QByteArray& img512k, const QString& device, quint64 sequence);
     void writeAllMonolithic();
     void saveMonolithic();
     void importRomAndCatalog();
@@ -29,37 +32,49 @@ private slots:
     void erase();
     void readDump();
     void terminal();
+    void programFleet();
+    void flushIdleWrites();
 
-    void onProcReadyRead();
-    void onProcFinished(int, QProcess::ExitStatus);
-    void onProcError(QProcess::ProcessError);
     void refreshDevices();
 
-    // NEU: echter Slot für den Watchdog
-    void onWatchdogTimeout();
-
 private:
-    struct Cmd {
-        QStringList args;
-        bool log = true;
-        QString label;
-        int timeoutMs = 0; // 0 = kein Timeout
+    void enqueue(const QStringList& args, const QString& label = QString(), bool log=true, int timeoutMs=0);
+    void enqueueMonolithic(DeviceRunner* runner, const QByteArray& blob, const PayloadPtr& payload);
+    void keepCopy(const QByteArray& blob);
+    PayloadPtr monolithicPayload(const QByteArray& blob);
+    void enqueueOn(DeviceRunner* runner, const QString& label, int timeoutMs,
+                   const QStringList& args, const PayloadPtr& payload = nullptr);
+    // One bank write batch: a run per bank (or one for the whole chip),
+    // host side prepared.
+    struct WriteRun {
+        int        first = 0;
+        int        count = 0;
+        QByteArray data;
+        QByteArray sha256;
+        PayloadPtr payload;     // what mxprog reads
+    };
+    struct WriteBatch {
+        QMap<int, QByteArray> banks;   // what it was prepared from
+        QVector<WriteRun>  runs;
+        QString            error;
     };
+    static WriteBatch prepareBatch(const QMap<int, QByteArray>& banks);
+    QMap<int, QByteArray> batchBanks(const QString& device) const;
+    void prepareAhead(const QString& device);
+    void flushWrites(const QString& device);
 
-    void enqueue(const QStringList& args, const QString& label = QString(), bool log=true, int timeoutMs=0);
-    void runNext();
+    // One job queue per programmer; "" = Auto (mxprog picks the device).
+    DeviceRunner* runnerFor(const QString& device);
+    QString selectedDevice() const;
+    void updateFleetRow(const QString& device);
 
     QByteArray buildMonolithic2MiB() const;
     QString timestampedDumpName() const;
     QString mxprogPath() const;
-    QString selectedDeviceArg() const;
     QString discoverMxprog() const;
     void loadSettings();
     void saveSettings() const;
 
-    void resetProgressTracking();
-    void appendSmart(const QString& chunk);
-
     QWidget*        m_central = nullptr;
     QLineEdit*      m_mxprogEdit = nullptr;
 
@@ -70,14 +85,22 @@ private:
 
     QVector<BankWidget*> m_banks;
 
-    QProcess*   m_proc = nullptr;
-    QQueue<Cmd> m_queue;
-    bool        m_running = false;
+    QMap<QString, DeviceRunner*> m_runners;
+    QProgressBar*      m_progBar = nullptr;   // selected device
 
-    QProgressBar*      m_progBar = nullptr;
-    int                m_progressBlock = -1;
-    bool               m_prevWasBlank  = false;
-    QRegularExpression m_rePercent{R"(^\d+%$)"};
+    // Fleet view: one row per detected programmer.
+    QTableWidget*      m_fleetTable = nullptr;
+    QHash<QString, int>    m_fleetDone;       // chips programmed per device
+    QHash<QString, qint64> m_fleetStarted;    // ms since epoch, running fleet job
 
-    QTimer* m_watchdog = nullptr;
+    // Bank write coalescing, per device: banks waiting for the runner, and
+    // the banks written since the chip's last erase (rewritten after the
+    // next one).
+    QHash<QString, QMap<int, QByteArray>> m_pendingWrites;
+    QHash<QString, QMap<int, QByteArray>> m_onChip;
+    QHash<QString, QMap<int, quint64>>    m_writeSequence;   // newest click taken per bank
+    QTimer*            m_coalesceTimer = nullptr;
+    // Batches prepared while the device is busy with the previous job.
+    QHash<QString, QFutureWatcher<WriteBatch>*> m_preparing;
+    QHash<QString, WriteBatch> m_prepared;
 };
@@ -0,0 +1,33 @@
+#include "MappedFile.h"
+
+MappedFile::MappedFile(const QString& path)
+    : m_file(path) {
+    if (!m_file.open(QIODevice::ReadOnly)) return;
+    m_open = true;
+
+    const qint64 fileSize = m_file.size();
+    if (fileSize > 0) {
+        m_map = m_file.map(0, fileSize);
+        if (m_map) {
+            m_size = qsizetype(fileSize);
+            return;
+        }
+    }
+
+    // Empty or unmappable: plain read, same interface.
+    m_fallback = m_file.readAll();
+    m_size = m_fallback.size();
+}
+
+MappedFile::~MappedFile() {
+    if (m_map) m_file.unmap(m_map);
+}
+
+const char* MappedFile::data() const {
+    return m_map ? reinterpret_cast<const char*>(m_map) : m_fallback.constData();
+}
+
+QByteArray MappedFile::bytes() const {
+    if (!m_map) return m_fallback;
+    return QByteArray::fromRawData(data(), m_size);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+/* ---------------------------------------------------------------------------
+   MappedFile – read-only, memory-mapped view of a ROM or part file.
+
+   Imports only inspect the bytes (size, byte order, signatures) before they
+   decide what to keep, so the file is mapped instead of read into a heap
+   buffer; the page cache backs the view.  Callers copy (or swap-copy) the
+   bytes they actually commit.  Falls back to readAll() when the file
+   cannot be mapped (pipes, some network filesystems).
+   The view returned by bytes() is only valid while the MappedFile lives.
+   ----------------------------------------------------------------------- */
+class MappedFile {
+public:
+    explicit MappedFile(const QString& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return m_open; }
+    bool isMapped() const { return m_map != nullptr; }
+    QString errorString() const { return m_file.errorString(); }
+
+    const char* data() const;
+    qsizetype size() const { return m_size; }
+
+    // Non-owning QByteArray over the mapped bytes (QByteArray::fromRawData).
+    QByteArray bytes() const;
+
+    // Deep copy of the bytes, independent of the mapping.
+    QByteArray copy() const { return QByteArray(data(), m_size); }
+
+private:
+    QFile m_file;
+    uchar* m_map = nullptr;
+    qsizetype m_size = 0;
+    QByteArray m_fallback;
+    bool m_open = false;
+};
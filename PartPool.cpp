@@ -0,0 +1,38 @@
+#include "PartPool.h"
+
+#include <QMutexLocker>
+
+PartPool& PartPool::instance() {
+    static PartPool pool;
+    return pool;
+}
+
+PartBlobPtr PartPool::find(const QByteArray& sha256) const {
+    QMutexLocker lock(&m_mutex);
+    return m_blobs.value(sha256).lock();
+}
+
+PartBlobPtr PartPool::acquire(const QByteArray& sha256, const std::function<QByteArray()>& bytes,
+                              const std::function<void(PartBlob&)>& analyze) {
+    if (PartBlobPtr hit = find(sha256)) return hit;
+
+    // Analysis runs unlocked; if another thread registered the same bytes
+    // meanwhile, its blob wins and this one is dropped.
+    auto blob = std::make_shared<PartBlob>();
+    blob->data = bytes();
+    blob->sha256 = sha256;
+    blob->laneSums = RomKernels::laneSums(blob->data.constData(), blob->data.size());
+    if (analyze) analyze(*blob);
+
+    QMutexLocker lock(&m_mutex);
+    if (PartBlobPtr raced = m_blobs.value(sha256).lock()) return raced;
+
+    // Drop the entries of blobs nobody holds any more.
+    for (auto it = m_blobs.begin(); it != m_blobs.end();) {
+        if (it.value().expired()) it = m_blobs.erase(it);
+        else ++it;
+    }
+    PartBlobPtr shared = std::move(blob);
+    m_blobs.insert(sha256, shared);
+    return shared;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QtGlobal>
+
+#include <functional>
+#include <memory>
+
+#include "RomKernels.h"
+#include "RomTagIndex.h"
+
+/* ---------------------------------------------------------------------------
+   PartBlob – the immutable bytes of a part plus everything derived from
+   them alone: digest, checksum lane sums, RomTag index and the address of
+   the leading RomTag.  Shared by every bank (and every undo state) that
+   holds the same bytes.
+   ----------------------------------------------------------------------- */
+struct PartBlob {
+    QByteArray  data;                   // canonical byte order
+    QByteArray  sha256;
+    RomKernels::LaneSums laneSums;
+    RomTagIndex tags;
+    quint32     romTagAddr = 0;         // rt_MatchTag of the leading RomTag, 0 = none
+};
+using PartBlobPtr = std::shared_ptr<const PartBlob>;
+
+/* ---------------------------------------------------------------------------
+   PartPool – process-wide registry of part blobs, keyed by SHA-256.
+
+   Holds weak references only: a blob lives as long as some part uses it,
+   and loading bytes that are already loaded anywhere hands out the same
+   blob instead of a second buffer and a second analysis.  Thread-safe.
+   ----------------------------------------------------------------------- */
+class PartPool {
+public:
+    static PartPool& instance();
+
+    // Blob for the bytes with digest `sha256`.  Only on a miss `bytes` is
+    // asked for the buffer to keep – the very bytes that were hashed, owned,
+    // not a second read of a view – and `analyze` fills in tags and
+    // romTagAddr; lane sums are computed here.
+    PartBlobPtr acquire(const QByteArray& sha256, const std::function<QByteArray()>& bytes,
+                        const std::function<void(PartBlob&)>& analyze);
+
+    // Live blob for `sha256`, or null.
+    PartBlobPtr find(const QByteArray& sha256) const;
+
+private:
+    PartPool() = default;
+
+    mutable QMutex m_mutex;
+    QHash<QByteArray, std::weak_ptr<const PartBlob>> m_blobs;
+};
@@ -0,0 +1,67 @@
+#include "Payload.h"
+
+#include <QCoreApplication>
+#include <QDir>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+#ifdef Q_OS_LINUX
+// Whole buffer into `fd`; false on a short write that makes no progress.
+static bool writeAll(int fd, const char* p, qint64 n) {
+    while (n > 0) {
+        const ssize_t w = ::write(fd, p, size_t(n));
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w;
+        n -= w;
+    }
+    return true;
+}
+#endif
+
+PayloadPtr Payload::create(const QByteArray& data, const QString& name, QString* error) {
+    std::shared_ptr<Payload> p(new Payload);
+    p->m_size = data.size();
+
+#ifdef Q_OS_LINUX
+    const int fd = ::memfd_create(name.toLocal8Bit().constData(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd >= 0) {
+        const bool ok = writeAll(fd, data.constData(), data.size())
+                        && ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == 0;
+        if (ok) {
+            p->m_fd = fd;
+            // The child opens it by our pid: its own /proc/self would not
+            // have the (close-on-exec) descriptor.
+            p->m_path = QString("/proc/%1/fd/%2").arg(QCoreApplication::applicationPid()).arg(fd);
+            return p;
+        }
+        ::close(fd);
+    }
+    // No memfd (old kernel, seccomp): temp file below.
+#endif
+
+    auto file = std::make_unique<QTemporaryFile>(QDir::temp().filePath(name + "_XXXXXX.bin"));
+    if (!file->open() || file->write(data) != data.size() || !file->flush()) {
+        if (error) *error = QString("cannot create payload file: %1").arg(file->errorString());
+        return nullptr;
+    }
+    file->close();
+    file->setPermissions(QFileDevice::ReadOwner);
+    p->m_path = file->fileName();
+    p->m_file = std::move(file);
+    return p;
+}
+
+Payload::~Payload() {
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0) ::close(m_fd);
+#endif
+    // Writable again, or the auto-remove fails on Windows.
+    if (m_file) m_file->setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+}
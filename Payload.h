@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QTemporaryFile>
+#include <QtGlobal>
+
+#include <memory>
+
+class Payload;
+using PayloadPtr = std::shared_ptr<const Payload>;
+
+/* ---------------------------------------------------------------------------
+   Payload – immutable bytes handed to mxprog by path.
+
+   mxprog only takes file names, so every write/verify needs its image
+   somewhere it can open.  On Linux that is an anonymous memfd, sealed
+   against any change, opened by the child through /proc/<pid>/fd/N: no
+   disk round trip, no name in /tmp.  Elsewhere (or without memfd) a unique
+   read-only temp file, removed with the Payload.
+
+   Each queued command owns its payload (shared_ptr), so the path stays
+   valid and its bytes unchanged until the last command reading it is
+   done; two batches for the same bank can no longer overwrite each other.
+   ----------------------------------------------------------------------- */
+class Payload {
+public:
+    // Copy of `data`; `name` only labels the memfd / temp file.  Null on
+    // failure, with the reason in *error.
+    static PayloadPtr create(const QByteArray& data, const QString& name, QString* error = nullptr);
+
+    ~Payload();
+    Payload(const Payload&) = delete;
+    Payload& operator=(const Payload&) = delete;
+
+    QString path() const { return m_path; }
+    qint64 size() const { return m_size; }
+    bool inMemory() const { return m_fd >= 0; }   // memfd, not a temp file
+
+private:
+    Payload() = default;
+
+    int     m_fd = -1;
+    QString m_path;
+    qint64  m_size = 0;
+    std::unique_ptr<QTemporaryFile> m_file;   // fallback
+};
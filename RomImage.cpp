@@ -0,0 +1,39 @@
+#include "RomImage.h"
+
+#include <cstring>
+
+RomSlice::RomSlice(const QByteArray& buffer, int off, int len)
+    : owner(buffer) {
+    offset = qBound(0, off, int(buffer.size()));
+    size = qBound(0, len, int(buffer.size()) - offset);
+}
+
+RomSlice RomSlice::mid(int off, int len) const {
+    off = qBound(0, off, size);
+    len = qBound(0, len, size - off);
+    RomSlice s;
+    s.owner = owner;
+    s.offset = offset + off;
+    s.size = len;
+    return s;
+}
+
+RomImage RomImage::fromRaw(const char* data, qsizetype size,
+                           RomKernels::ByteOrder order, qsizetype paddedSize) {
+    RomImage img;
+    const qsizetype canonicalSize = (order == RomKernels::ByteOrder::WordSwapped)
+                                        ? ((size + 1) & ~qsizetype(1))
+                                        : size;
+    img.m_canonicalSize = int(canonicalSize);
+
+    // One allocation for the whole image; only the tail gets the 0xFF fill.
+    img.m_buffer = QByteArray(qMax(paddedSize, canonicalSize), Qt::Uninitialized);
+    char* out = img.m_buffer.data();
+    if (order == RomKernels::ByteOrder::WordSwapped) {
+        RomKernels::swap16Copy(data, size, out);
+    } else if (size > 0) {
+        std::memcpy(out, data, size_t(size));
+    }
+    std::memset(out + canonicalSize, 0xff, size_t(img.m_buffer.size() - canonicalSize));
+    return img;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtGlobal>
+
+#include "RomKernels.h"
+
+/* ---------------------------------------------------------------------------
+   RomSlice – lightweight view of [offset, offset + size) in a shared buffer.
+
+   Holds an implicitly shared reference to the owner's bytes, so banks and
+   components of one ROM all point into the same allocation.  The owner is
+   never written through a slice, so it never detaches.  view() hands out a
+   non-owning QByteArray (valid while the slice lives) for hashing/writing;
+   toByteArray() is the explicit copy for callers that keep bytes around.
+   ----------------------------------------------------------------------- */
+struct RomSlice {
+    QByteArray owner;
+    int offset = 0;
+    int size = 0;
+
+    RomSlice() = default;
+    RomSlice(const QByteArray& buffer, int off, int len);
+
+    bool isEmpty() const { return size <= 0; }
+    const char* constData() const { return owner.constData() + offset; }
+
+    QByteArray view() const { return QByteArray::fromRawData(constData(), size); }
+    QByteArray toByteArray() const { return QByteArray(constData(), size); }
+
+    // Sub-slice relative to this slice, clamped to it.
+    RomSlice mid(int off, int len) const;
+};
+
+/* ---------------------------------------------------------------------------
+   RomImage – single owner of an imported ROM in canonical byte order.
+
+   One buffer of paddedSize bytes: the input (swapped on the way in if
+   needed) followed by 0xFF padding.  canonical() covers the bytes that came
+   from the file, padded() the whole buffer; banks and components are
+   further slices of the same allocation.
+   ----------------------------------------------------------------------- */
+class RomImage {
+public:
+    RomImage() = default;
+
+    // Copy (or word-swap) `size` raw bytes into a new buffer of at least
+    // `paddedSize` bytes.  A swapped odd-sized input gains its 0xFF pad byte
+    // as part of the canonical data, exactly like RomTools::swap16().
+    static RomImage fromRaw(const char* data, qsizetype size,
+                            RomKernels::ByteOrder order, qsizetype paddedSize);
+
+    bool isNull() const { return m_buffer.isNull(); }
+    int canonicalSize() const { return m_canonicalSize; }
+    int paddedSize() const { return int(m_buffer.size()); }
+
+    RomSlice canonical() const { return RomSlice(m_buffer, 0, m_canonicalSize); }
+    RomSlice padded() const { return RomSlice(m_buffer, 0, int(m_buffer.size())); }
+    RomSlice slice(int off, int len) const { return padded().mid(off, len); }
+
+private:
+    QByteArray m_buffer;
+    int m_canonicalSize = 0;
+};
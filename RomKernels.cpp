@@ -0,0 +1,362 @@
+#include "RomKernels.h"
+
+#include <algorithm>
+#include <iterator>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define ROMKERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define ROMKERNELS_AVX2_TARGET
+#else
+#define ROMKERNELS_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace RomKernels {
+
+namespace {
+
+inline quint32 loadBe32(const unsigned char* p) {
+    return (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | quint32(p[3]);
+}
+
+quint64 sumBe32Scalar(const unsigned char* p, qsizetype longs) {
+    quint64 sum = 0;
+    for (qsizetype i = 0; i < longs; ++i, p += 4) sum += loadBe32(p);
+    return sum;
+}
+
+// RomTag magic as a byte pair: p[j] == first && p[j + dist] == second,
+// reported as offset j + shift.  Canonical data has 4A FC at the magic; in a
+// word-swapped buffer the same magic shows up as FC 4A (even offsets) or as
+// 4A .. .. FC one byte before it (odd offsets).
+struct PairPattern {
+    unsigned char first;
+    unsigned char second;
+    int dist;
+    int shift;
+};
+
+void findPairsScalar(const unsigned char* p, qsizetype from, qsizetype to, qsizetype step,
+                     const PairPattern& pat, QVector<int>& out) {
+    for (qsizetype j = from; j < to; j += step) {
+        if (p[j] == pat.first && p[j + pat.dist] == pat.second) out.push_back(int(j + pat.shift));
+    }
+}
+
+void swapPairsScalar(const unsigned char* src, unsigned char* dst, qsizetype from, qsizetype to) {
+    for (qsizetype i = from; i + 1 < to; i += 2) {
+        const unsigned char a = src[i];
+        dst[i] = src[i + 1];
+        dst[i + 1] = a;
+    }
+}
+
+inline void appendMaskHits(quint32 mask, qsizetype base, QVector<int>& out) {
+    while (mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long bit;
+        _BitScanForward(&bit, mask);
+#else
+        const int bit = __builtin_ctz(mask);
+#endif
+        out.push_back(int(base + bit));
+        mask &= mask - 1;
+    }
+}
+
+#ifdef ROMKERNELS_X86
+
+// Byte-swap every 32-bit lane (SSE2 has no pshufb: swap bytes inside the
+// 16-bit halves, then swap the halves).
+inline __m128i bswap32Sse2(__m128i v) {
+    const __m128i t = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    return _mm_or_si128(_mm_slli_epi32(t, 16), _mm_srli_epi32(t, 16));
+}
+
+quint64 sumBe32Sse2(const unsigned char* p, qsizetype longs) {
+    const __m128i lowMask = _mm_set_epi32(0, -1, 0, -1);
+    __m128i acc = _mm_setzero_si128();
+
+    qsizetype i = 0;
+    for (; i + 4 <= longs; i += 4, p += 16) {
+        const __m128i v = bswap32Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        // Widen even/odd longwords into 64-bit lanes so nothing overflows.
+        acc = _mm_add_epi64(acc, _mm_and_si128(v, lowMask));
+        acc = _mm_add_epi64(acc, _mm_srli_epi64(v, 32));
+    }
+
+    quint64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + sumBe32Scalar(p, longs - i);
+}
+
+// Exchange the bytes of every 16-bit word; src == dst is fine (each block
+// is loaded before it is stored).
+qsizetype swapPairsSse2(const unsigned char* src, unsigned char* dst, qsizetype size) {
+    qsizetype i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+    }
+    return i;
+}
+
+ROMKERNELS_AVX2_TARGET
+qsizetype swapPairsAvx2(const unsigned char* src, unsigned char* dst, qsizetype size) {
+    const __m256i swap = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                          1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    qsizetype i = 0;
+    for (; i + 64 <= size; i += 64) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(a, swap));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), _mm256_shuffle_epi8(b, swap));
+    }
+    return i + swapPairsSse2(src + i, dst + i, size - i);
+}
+
+// Pair offsets in [0, to): compare 16 bytes against `first` and the 16
+// bytes `dist` further on against `second`; the AND of both masks marks a
+// hit.  The caller keeps to + dist <= size so the second load stays in bounds.
+qsizetype findPairsSse2(const unsigned char* p, qsizetype to, bool wordOnly,
+                        const PairPattern& pat, QVector<int>& out) {
+    const __m128i first = _mm_set1_epi8(char(pat.first));
+    const __m128i second = _mm_set1_epi8(char(pat.second));
+    const quint32 keep = wordOnly ? 0x5555u : 0xFFFFu;
+    qsizetype i = 0;
+    for (; i + 16 <= to; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + pat.dist));
+        const quint32 mask = quint32(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, second)))) & keep;
+        appendMaskHits(mask, i + pat.shift, out);
+    }
+    return i;
+}
+
+ROMKERNELS_AVX2_TARGET
+qsizetype findPairsAvx2(const unsigned char* p, qsizetype to, bool wordOnly,
+                        const PairPattern& pat, QVector<int>& out) {
+    const __m256i first = _mm256_set1_epi8(char(pat.first));
+    const __m256i second = _mm256_set1_epi8(char(pat.second));
+    const quint32 keep = wordOnly ? 0x55555555u : 0xFFFFFFFFu;
+    qsizetype i = 0;
+    for (; i + 32 <= to; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + pat.dist));
+        const quint32 mask = quint32(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, second)))) & keep;
+        appendMaskHits(mask, i + pat.shift, out);
+    }
+    return i;
+}
+
+ROMKERNELS_AVX2_TARGET
+quint64 sumBe32Avx2(const unsigned char* p, qsizetype longs) {
+    const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                           3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256i lowMask = _mm256_set_epi32(0, -1, 0, -1, 0, -1, 0, -1);
+    __m256i accA = _mm256_setzero_si256();
+    __m256i accB = _mm256_setzero_si256();
+
+    qsizetype i = 0;
+    for (; i + 16 <= longs; i += 16, p += 64) {
+        const __m256i a = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), bswap);
+        const __m256i b = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)), bswap);
+        accA = _mm256_add_epi64(accA, _mm256_and_si256(a, lowMask));
+        accA = _mm256_add_epi64(accA, _mm256_srli_epi64(a, 32));
+        accB = _mm256_add_epi64(accB, _mm256_and_si256(b, lowMask));
+        accB = _mm256_add_epi64(accB, _mm256_srli_epi64(b, 32));
+    }
+
+    alignas(32) quint64 lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(accA, accB));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumBe32Sse2(p, longs - i);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4] = {};
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // ROMKERNELS_X86
+
+enum class Isa { Scalar, Sse2, Avx2 };
+
+Isa detectIsa() {
+#ifdef ROMKERNELS_X86
+    if (qEnvironmentVariableIsSet("MXPROG_NO_SIMD")) return Isa::Scalar;
+    return cpuHasAvx2() ? Isa::Avx2 : Isa::Sse2;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+Isa activeIsa() {
+    static const Isa isa = detectIsa();
+    return isa;
+}
+
+// Pair offsets j in [0, to) with the given stride; j + dist must stay < size.
+void findPairs(const unsigned char* p, qsizetype size, qsizetype to, bool wordOnly,
+               const PairPattern& pat, QVector<int>& out) {
+    to = qMin(to, size - pat.dist);
+    if (to <= 0) return;
+
+    qsizetype done = 0;
+    switch (activeIsa()) {
+#ifdef ROMKERNELS_X86
+    case Isa::Avx2: done = findPairsAvx2(p, to, wordOnly, pat, out); break;
+    case Isa::Sse2: done = findPairsSse2(p, to, wordOnly, pat, out); break;
+#endif
+    default: break;
+    }
+    findPairsScalar(p, done, to, wordOnly ? 2 : 1, pat, out);
+}
+
+// Swap the complete 16-bit words of [src, src + size) into dst.
+void swapPairs(const unsigned char* src, unsigned char* dst, qsizetype size) {
+    qsizetype done = 0;
+    switch (activeIsa()) {
+#ifdef ROMKERNELS_X86
+    case Isa::Avx2: done = swapPairsAvx2(src, dst, size); break;
+    case Isa::Sse2: done = swapPairsSse2(src, dst, size); break;
+#endif
+    default: break;
+    }
+    swapPairsScalar(src, dst, done, size);
+}
+
+} // namespace
+
+quint64 sumBe32(const char* data, qsizetype size) {
+    if (!data || size < 4) return 0;
+    const auto* p = reinterpret_cast<const unsigned char*>(data);
+    const qsizetype longs = size / 4;
+    switch (activeIsa()) {
+#ifdef ROMKERNELS_X86
+    case Isa::Avx2: return sumBe32Avx2(p, longs);
+    case Isa::Sse2: return sumBe32Sse2(p, longs);
+#endif
+    default:        return sumBe32Scalar(p, longs);
+    }
+}
+
+quint32 reduceSum(quint64 rawSum, ChecksumMode mode) {
+    if (mode == ChecksumMode::Additive) return quint32(rawSum & 0xFFFFFFFFu);
+
+    // Folding the carries of the wide sum back in is equivalent to adding
+    // longword by longword with end-around carry (ones' complement add).
+    while (rawSum >> 32) rawSum = (rawSum & 0xFFFFFFFFu) + (rawSum >> 32);
+    return quint32(rawSum);
+}
+
+QVector<int> findRomTagCandidates(const char* data, qsizetype size, TagStride stride,
+                                  qsizetype minSpan, ByteOrder order) {
+    QVector<int> out;
+    minSpan = qMax<qsizetype>(minSpan, 2);
+    if (!data) return out;
+
+    const auto* p = reinterpret_cast<const unsigned char*>(data);
+    const bool wordOnly = (stride == TagStride::Word);
+
+    if (order == ByteOrder::Canonical) {
+        if (size < minSpan) return out;
+        findPairs(p, size, size - minSpan + 1, wordOnly, { 0x4A, 0xFC, 1, 0 }, out);
+        return out;
+    }
+
+    // Word-swapped: offsets refer to the logical (swapped, 0xFF-padded) view.
+    const qsizetype viewSize = (size + 1) & ~qsizetype(1);
+    if (viewSize < minSpan) return out;
+    const qsizetype end = viewSize - minSpan + 1;
+
+    findPairs(p, size, end, true, { 0xFC, 0x4A, 1, 0 }, out);
+    if (wordOnly) return out;
+
+    QVector<int> odd;
+    findPairs(p, size, end - 1, true, { 0x4A, 0xFC, 3, 1 }, odd);
+    if (odd.isEmpty()) return out;
+
+    QVector<int> merged;
+    merged.reserve(out.size() + odd.size());
+    std::merge(out.cbegin(), out.cend(), odd.cbegin(), odd.cend(), std::back_inserter(merged));
+    return merged;
+}
+
+LaneSums laneSums(const char* data, qsizetype size) {
+    LaneSums out;
+    if (!data || size <= 0) return out;
+    const auto* p = reinterpret_cast<const unsigned char*>(data);
+    qsizetype i = 0;
+    for (; i + 4 <= size; i += 4) {
+        out.lane[0] += p[i + 0];
+        out.lane[1] += p[i + 1];
+        out.lane[2] += p[i + 2];
+        out.lane[3] += p[i + 3];
+    }
+    for (; i < size; ++i) out.lane[i & 3] += p[i];
+    return out;
+}
+
+quint64 placedSum(const LaneSums& lanes, qsizetype offset) {
+    static const quint64 weight[4] = { 1ull << 24, 1ull << 16, 1ull << 8, 1ull };
+    quint64 sum = 0;
+    for (int k = 0; k < 4; ++k) sum += lanes.lane[k] * weight[(offset + k) & 3];
+    return sum;
+}
+
+quint64 fillSum(qsizetype offset, qsizetype size, unsigned char fill) {
+    if (size <= 0) return 0;
+    LaneSums lanes;
+    for (int k = 0; k < 4; ++k) {
+        const qsizetype count = (size > k) ? (size - k + 3) / 4 : 0;
+        lanes.lane[k] = quint64(count) * fill;
+    }
+    return placedSum(lanes, offset);
+}
+
+void swap16InPlace(char* data, qsizetype size) {
+    if (!data || size < 2) return;
+    auto* p = reinterpret_cast<unsigned char*>(data);
+    swapPairs(p, p, size & ~qsizetype(1));
+}
+
+void swap16Copy(const char* src, qsizetype size, char* dst) {
+    if (!src || !dst || size <= 0) return;
+    const auto* s = reinterpret_cast<const unsigned char*>(src);
+    auto* d = reinterpret_cast<unsigned char*>(dst);
+    const qsizetype even = size & ~qsizetype(1);
+    swapPairs(s, d, even);
+    if (even != size) {
+        // Odd tail: pad to a full word with 0xFF, then swap that word too.
+        d[even] = 0xff;
+        d[even + 1] = s[even];
+    }
+}
+
+const char* kernelName() {
+    switch (activeIsa()) {
+    case Isa::Avx2: return "avx2";
+    case Isa::Sse2: return "sse2";
+    default:        return "scalar";
+    }
+}
+
+} // namespace RomKernels
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+/* ---------------------------------------------------------------------------
+   RomKernels – hot byte loops shared by RomTools and BankWidget.
+
+   Each entry point dispatches once at runtime to an AVX2, SSE2 or portable
+   scalar implementation; all variants produce bit-identical results.
+   ----------------------------------------------------------------------- */
+namespace RomKernels {
+
+// Kickstart checksum flavours over 32-bit big-endian longwords:
+//   Additive  – plain modulo-2^32 sum
+//   CarryFold – ones' complement sum with end-around carry, as done by
+//               exec.library's SumKickData (add.l / bcc / addq.l #1)
+enum class ChecksumMode { Additive, CarryFold };
+
+// Raw 64-bit sum of all complete big-endian longwords in [data, data+size).
+// Trailing bytes that do not fill a longword are ignored.
+quint64 sumBe32(const char* data, qsizetype size);
+
+// Reduce a raw sum from sumBe32() to the 32-bit checksum sum of `mode`.
+quint32 reduceSum(quint64 rawSum, ChecksumMode mode);
+
+// Byte sums per longword lane: lane[k] sums all bytes at index ≡ k (mod 4).
+// Because the raw longword sum is linear in the bytes, these four values are
+// enough to know a block's sumBe32() contribution at any placement offset.
+struct LaneSums {
+    quint64 lane[4] = {0, 0, 0, 0};
+};
+
+LaneSums laneSums(const char* data, qsizetype size);
+
+// Raw sumBe32() contribution of a block with `lanes` placed at image `offset`.
+quint64 placedSum(const LaneSums& lanes, qsizetype offset);
+
+// Raw sumBe32() contribution of `size` bytes of value `fill` at `offset`.
+quint64 fillSum(qsizetype offset, qsizetype size, unsigned char fill);
+
+// Byte order of a ROM buffer: canonical big-endian as the 68000 sees it, or
+// word-swapped (every 16-bit pair exchanged, the historical .rom layout).
+enum class ByteOrder { Canonical, WordSwapped };
+
+// RomTag candidate search: offsets of the 0x4AFC (ILLEGAL) magic word.
+//   Byte – every byte offset is a candidate (component scans, validation)
+//   Word – only even offsets (how exec scans ROM for Residents)
+// Only offsets with at least `minSpan` bytes left in the buffer are reported,
+// so callers can decode the Resident structure without further bounds checks.
+// For WordSwapped input the raw buffer is searched in place and offsets (and
+// `minSpan`) refer to its canonical view, padded with 0xFF to an even size.
+enum class TagStride { Byte, Word };
+
+QVector<int> findRomTagCandidates(const char* data, qsizetype size, TagStride stride,
+                                  qsizetype minSpan = 2,
+                                  ByteOrder order = ByteOrder::Canonical);
+
+// Word swap (exchange the two bytes of every 16-bit word), converting
+// between canonical and word-swapped order in either direction.
+//   swap16InPlace – swaps the complete words of `data`; an odd trailing byte
+//                   stays where it is (callers pad first, see RomTools::swap16)
+//   swap16Copy    – writes the swapped bytes of `src` to `dst`, which must
+//                   hold (size + 1) & ~1 bytes; an odd input is padded with
+//                   0xFF to an even size before swapping.  src != dst.
+void swap16InPlace(char* data, qsizetype size);
+void swap16Copy(const char* src, qsizetype size, char* dst);
+
+// Name of the implementation picked for this CPU ("avx2", "sse2", "scalar").
+const char* kernelName();
+
+} // namespace RomKernels
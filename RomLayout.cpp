@@ -0,0 +1,78 @@
+#include "RomLayout.h"
+
+#include <iterator>
+
+RomLayout::RomLayout(int size)
+    : m_size(qMax(0, size)) {
+}
+
+void RomLayout::claim(int from, int to, int id) {
+    if (from >= to) return;
+    m_used.emplace(from, Span{ to, id });
+}
+
+bool RomLayout::reserve(int id, int offset, int length) {
+    if (offset < 0 || length < 0 || offset + length > m_size) return false;
+    const int end = offset + length;
+    m_freeValid = false;
+
+    // First span that could reach into [offset, end): the one starting at or
+    // before offset (if it extends past it), else the next one.
+    auto it = m_used.upper_bound(offset);
+    if (it != m_used.begin()) {
+        auto prev = std::prev(it);
+        if (prev->second.end > offset) it = prev;
+    }
+
+    // Walk the spans inside the range; the holes between them are ours.
+    int cursor = offset;
+    while (it != m_used.end() && it->first < end) {
+        const int from = qMax(it->first, offset);
+        const int to = qMin(it->second.end, end);
+        m_overlaps.push_back(Overlap{ it->second.id, id, from, to });
+        claim(cursor, from, id);
+        cursor = qMax(cursor, it->second.end);
+        ++it;
+    }
+    claim(cursor, end, id);
+    return true;
+}
+
+void RomLayout::rebuildFree() const {
+    m_free.clear();
+    for (const auto& g : gaps())
+        m_free.emplace(g.second - g.first, g.first);
+    m_freeValid = true;
+}
+
+int RomLayout::place(int id, int length, int align) {
+    if (length <= 0 || align <= 0) return -1;
+    if (!m_freeValid) rebuildFree();
+
+    // Smallest gap first; alignment can cost up to align-1 bytes, so the
+    // tightest candidate may not fit and the next one is tried.
+    for (auto it = m_free.lower_bound(length); it != m_free.end(); ++it) {
+        const int gapStart = it->second;
+        const int gapEnd = gapStart + it->first;
+        const int start = (gapStart + align - 1) / align * align;
+        if (start + length > gapEnd) continue;
+
+        m_free.erase(it);
+        claim(start, start + length, id);
+        if (start > gapStart) m_free.emplace(start - gapStart, gapStart);
+        if (gapEnd > start + length) m_free.emplace(gapEnd - (start + length), start + length);
+        return start;
+    }
+    return -1;
+}
+
+QVector<QPair<int, int>> RomLayout::gaps() const {
+    QVector<QPair<int, int>> out;
+    int cursor = 0;
+    for (const auto& u : m_used) {
+        if (u.first > cursor) out.push_back(qMakePair(cursor, u.first));
+        cursor = qMax(cursor, u.second.end);
+    }
+    if (cursor < m_size) out.push_back(qMakePair(cursor, m_size));
+    return out;
+}
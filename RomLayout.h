@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QPair>
+#include <QVector>
+#include <QtGlobal>
+
+#include <map>
+
+/* ---------------------------------------------------------------------------
+   RomLayout – occupancy of one bank's address space (256 or 512 KiB).
+
+   Occupied space is an ordered map of disjoint intervals, each owned by
+   the part that claimed it first.  reserve() pins a part at a fixed offset
+   (its original ROM address) and reports every earlier part it collides
+   with, O(log n) per reservation plus one step per collision.  place()
+   puts a part of unknown address into the free gap that fits it most
+   tightly (best-fit, word-aligned).
+   ----------------------------------------------------------------------- */
+class RomLayout {
+public:
+    struct Overlap {
+        int first;    // part that held the range
+        int second;   // part that collided with it
+        int from;     // first overlapping byte
+        int to;       // one past the last overlapping byte
+    };
+
+    explicit RomLayout(int size);
+
+    int size() const { return m_size; }
+
+    // Claim [offset, offset + length) for `id`.  Ranges already held stay
+    // with their owner and are recorded in overlaps(); only the uncovered
+    // rest is claimed.  False when the range leaves the address space.
+    bool reserve(int id, int offset, int length);
+
+    // Best-fit placement: claim the smallest free gap that holds `length`
+    // bytes at an `align`-aligned start.  Returns the offset, -1 if no gap
+    // is large enough.
+    int place(int id, int length, int align = 2);
+
+    const QVector<Overlap>& overlaps() const { return m_overlaps; }
+
+    // Free [from, to) ranges in address order.
+    QVector<QPair<int, int>> gaps() const;
+
+private:
+    struct Span {
+        int end;
+        int id;
+    };
+
+    void claim(int from, int to, int id);
+    void rebuildFree() const;
+
+    int m_size;
+    std::map<int, Span> m_used;                 // start → span
+    QVector<Overlap> m_overlaps;
+
+    // Free gaps by size for best-fit; rebuilt after reserve().
+    mutable std::multimap<int, int> m_free;     // length → start
+    mutable bool m_freeValid = false;
+};
@@ -0,0 +1,213 @@
+#include "RomTagIndex.h"
+#include "RomKernels.h"
+
+namespace {
+
+quint16 readBe16(const QByteArray& data, int offset) {
+    if (offset < 0 || offset + 2 > data.size()) return 0;
+    const auto* p = reinterpret_cast<const unsigned char*>(data.constData() + offset);
+    return quint16((quint16(p[0]) << 8) | p[1]);
+}
+
+quint32 readBe32(const QByteArray& data, int offset) {
+    if (offset < 0 || offset + 4 > data.size()) return 0;
+    const auto* p = reinterpret_cast<const unsigned char*>(data.constData() + offset);
+    return (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | quint32(p[3]);
+}
+
+} // namespace
+
+void RomTagIndex::clear() {
+    offset.clear();
+    matchTag.clear();
+    endSkip.clear();
+    flags.clear();
+    pri.clear();
+    name.clear();
+    idString.clear();
+    init.clear();
+    initStruct.clear();
+    funcTable.clear();
+    dataInit.clear();
+    initFunc.clear();
+    funcEntries.clear();
+}
+
+void RomTagIndex::reserve(int n) {
+    offset.reserve(n);
+    matchTag.reserve(n);
+    endSkip.reserve(n);
+    flags.reserve(n);
+    pri.reserve(n);
+    name.reserve(n);
+    idString.reserve(n);
+    init.reserve(n);
+    initStruct.reserve(n);
+    funcTable.reserve(n);
+    dataInit.reserve(n);
+    initFunc.reserve(n);
+    funcEntries.reserve(n);
+}
+
+RomTagIndex RomTagIndex::build(const QByteArray& data) {
+    RomTagIndex idx;
+    const auto candidates = RomKernels::findRomTagCandidates(data.constData(), data.size(),
+                                                             RomKernels::TagStride::Byte, RESIDENT_SIZE);
+    idx.reserve(candidates.size());
+    for (const int off : candidates) idx.decodeAt(data, off);
+    for (int i = 0; i < idx.size(); ++i) idx.locateFuncEntries(data, i);
+    return idx;
+}
+
+RomTagIndex RomTagIndex::fromSites(const QByteArray& data, const QVector<int>& offsets,
+                                   const QVector<QVector<int>>* funcEntries) {
+    RomTagIndex idx;
+    idx.reserve(offsets.size());
+    for (int k = 0; k < offsets.size(); ++k) {
+        const int off = offsets[k];
+        if (off < 0 || off + RESIDENT_SIZE > data.size() || readBe16(data, off) != 0x4AFC
+            || (!idx.isEmpty() && off <= idx.offset.back()))
+            return {};
+        idx.decodeAt(data, off);
+        if (funcEntries && k < funcEntries->size())
+            idx.funcEntries.back() = funcEntries->at(k);
+        else
+            idx.locateFuncEntries(data, idx.size() - 1);
+    }
+    return idx;
+}
+
+void RomTagIndex::append(const RomTagIndex& other, int shift, int limit) {
+    reserve(size() + other.size());
+    for (int i = 0; i < other.size(); ++i) {
+        const int off = other.offset[i] + shift;
+        if (off < 0 || off + RESIDENT_SIZE > limit) continue;
+        const int iso = other.initStruct[i];
+        const bool structFits = iso >= 0 && iso + shift + INIT_STRUCT_SIZE <= limit;
+
+        offset.push_back(off);
+        matchTag.push_back(other.matchTag[i]);
+        endSkip.push_back(other.endSkip[i]);
+        flags.push_back(other.flags[i]);
+        pri.push_back(other.pri[i]);
+        name.push_back(other.name[i]);
+        idString.push_back(other.idString[i]);
+        init.push_back(other.init[i]);
+        initStruct.push_back(structFits ? iso + shift : -1);
+        funcTable.push_back(structFits ? other.funcTable[i] : 0);
+        dataInit.push_back(structFits ? other.dataInit[i] : 0);
+        initFunc.push_back(structFits ? other.initFunc[i] : 0);
+
+        QVector<int> entries;
+        for (const int e : other.funcEntries[i]) {
+            if (e + shift >= 0 && e + shift + 4 <= limit) entries.push_back(e + shift);
+        }
+        funcEntries.push_back(std::move(entries));
+    }
+}
+
+void RomTagIndex::addRange(const QByteArray& data, int from, int to) {
+    from = qMax(from, 0);
+    to = qMin(to, int(data.size()) - RESIDENT_SIZE + 1);
+    if (from >= to) return;
+    const auto candidates = RomKernels::findRomTagCandidates(data.constData() + from,
+                                                             (to - from) + RESIDENT_SIZE - 1,
+                                                             RomKernels::TagStride::Byte, RESIDENT_SIZE);
+    for (const int rel : candidates) {
+        const int off = from + rel;
+        if (!offset.isEmpty() && off <= offset.back()) continue;
+        decodeAt(data, off);
+    }
+}
+
+RomTagIndex RomTagIndex::section(int from, int to) const {
+    RomTagIndex out;
+    for (int i = 0; i < size(); ++i) {
+        const int off = offset[i];
+        if (off < from || off + RESIDENT_SIZE > to) continue;
+        const int iso = initStruct[i];
+        const bool structInside = iso >= from && iso + INIT_STRUCT_SIZE <= to;
+
+        out.offset.push_back(off - from);
+        out.matchTag.push_back(matchTag[i]);
+        out.endSkip.push_back(endSkip[i]);
+        out.flags.push_back(flags[i]);
+        out.pri.push_back(pri[i]);
+        out.name.push_back(name[i]);
+        out.idString.push_back(idString[i]);
+        out.init.push_back(init[i]);
+        out.initStruct.push_back(structInside ? iso - from : -1);
+        out.funcTable.push_back(structInside ? funcTable[i] : 0);
+        out.dataInit.push_back(structInside ? dataInit[i] : 0);
+        out.initFunc.push_back(structInside ? initFunc[i] : 0);
+
+        QVector<int> entries;
+        for (const int e : funcEntries[i]) {
+            if (e >= from && e + 4 <= to) entries.push_back(e - from);
+        }
+        out.funcEntries.push_back(std::move(entries));
+    }
+    return out;
+}
+
+void RomTagIndex::refresh(const QByteArray& data, int i) {
+    if (i < 0 || i >= size()) return;
+    RomTagIndex one;
+    one.decodeAt(data, offset[i]);
+    matchTag[i]   = one.matchTag[0];
+    endSkip[i]    = one.endSkip[0];
+    flags[i]      = one.flags[0];
+    pri[i]        = one.pri[0];
+    name[i]       = one.name[0];
+    idString[i]   = one.idString[0];
+    init[i]       = one.init[0];
+    initStruct[i] = one.initStruct[0];
+    funcTable[i]  = one.funcTable[0];
+    dataInit[i]   = one.dataInit[0];
+    initFunc[i]   = one.initFunc[0];
+    // funcEntries are positions, which patching does not move.
+}
+
+void RomTagIndex::decodeAt(const QByteArray& data, int off) {
+    const quint32 tag = readBe32(data, off + 2) & 0x00FFFFFFu;
+    const quint8 fl = static_cast<quint8>(data.at(off + 10));
+    const quint32 initPtr = readBe32(data, off + 22) & 0x00FFFFFFu;
+
+    offset.push_back(off);
+    matchTag.push_back(tag);
+    endSkip.push_back(readBe32(data, off + 6) & 0x00FFFFFFu);
+    flags.push_back(fl);
+    pri.push_back(static_cast<qint8>(data.at(off + 13)));
+    name.push_back(readBe32(data, off + 14) & 0x00FFFFFFu);
+    idString.push_back(readBe32(data, off + 18) & 0x00FFFFFFu);
+    init.push_back(initPtr);
+
+    // rt_Init is absolute, but relative to rt_MatchTag (the tag's own
+    // address) it locates the init struct inside this buffer at any base.
+    int iso = -1;
+    if ((fl & 0x80) && initPtr != 0 && tag != 0) {
+        const qint64 rel = qint64(off) + qint64(initPtr) - qint64(tag);
+        if (rel >= 0 && rel + INIT_STRUCT_SIZE <= data.size()) iso = int(rel);
+    }
+    initStruct.push_back(iso);
+    funcTable.push_back(iso >= 0 ? readBe32(data, iso + 4) & 0x00FFFFFFu : 0);
+    dataInit.push_back(iso >= 0 ? readBe32(data, iso + 8) & 0x00FFFFFFu : 0);
+    initFunc.push_back(iso >= 0 ? readBe32(data, iso + 12) & 0x00FFFFFFu : 0);
+    funcEntries.push_back({});
+}
+
+// Same walk the relocator does: an absolute table (first word != 0xFFFF)
+// runs until 0xFFFFFFFF; entries below 0xF80000 are not ROM pointers.
+void RomTagIndex::locateFuncEntries(const QByteArray& data, int i) {
+    if (initStruct[i] < 0 || funcTable[i] == 0) return;
+    const qint64 ft = qint64(offset[i]) + qint64(funcTable[i]) - qint64(matchTag[i]);
+    if (ft < 0 || ft + 2 > data.size() || readBe16(data, int(ft)) == 0xFFFF) return;
+
+    QVector<int>& entries = funcEntries[i];
+    const int maxEntries = 256;
+    for (int n = 0, e = int(ft); n < maxEntries && e + 4 <= data.size(); ++n, e += 4) {
+        const quint32 entry = readBe32(data, e);
+        if (entry == 0xFFFFFFFFu) break;
+        if ((entry & 0x00FFFFFFu) >= 0x00F80000u) entries.push_back(e);
+    }
+}
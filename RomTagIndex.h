@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+#include <QtGlobal>
+
+/* ---------------------------------------------------------------------------
+   RomTagIndex – decoded Resident (RomTag) structures of one buffer.
+
+   Built once per part buffer (one vectorized 0x4AFC pass) and then shared by
+   every validator and by the relocator instead of re-parsing the bytes.
+   Struct-of-arrays: entry i of every vector describes the RomTag at
+   offset[i]; entries are sorted by offset.  Pointers are stored 24-bit
+   masked, the way the Amiga address decoder sees them.
+   ----------------------------------------------------------------------- */
+struct RomTagIndex {
+    static constexpr int RESIDENT_SIZE = 26;    // sizeof(struct Resident)
+    static constexpr int INIT_STRUCT_SIZE = 16; // RTF_AUTOINIT init struct
+
+    QVector<int>     offset;     // byte offset of the 0x4AFC magic
+    QVector<quint32> matchTag;   // rt_MatchTag  (+2)
+    QVector<quint32> endSkip;    // rt_EndSkip   (+6)
+    QVector<quint8>  flags;      // rt_Flags     (+10)
+    QVector<qint8>   pri;        // rt_Pri       (+13)
+    QVector<quint32> name;       // rt_Name      (+14)
+    QVector<quint32> idString;   // rt_IdString  (+18)
+    QVector<quint32> init;       // rt_Init      (+22)
+
+    // RTF_AUTOINIT: offset of the init struct in the same buffer (-1 = none)
+    // and the three pointers following its dataSize longword.
+    QVector<int>     initStruct;
+    QVector<quint32> funcTable;  // +4
+    QVector<quint32> dataInit;   // +8
+    QVector<quint32> initFunc;   // +12
+
+    // Offsets of the absolute (non 0xFFFF-relative) function table entries
+    // that hold ROM pointers, when the table lies in the same buffer.
+    QVector<QVector<int>> funcEntries;
+
+    int size() const { return offset.size(); }
+    bool isEmpty() const { return offset.isEmpty(); }
+    void clear();
+    void reserve(int n);
+
+    // Index every 0x4AFC with a complete Resident structure in `data`.
+    static RomTagIndex build(const QByteArray& data);
+
+    // Same, but from known RomTag offsets (e.g. persisted in a catalog):
+    // nothing is scanned.  Offsets that do not hold a complete 0x4AFC
+    // Resident make the result empty, so callers can fall back to build().
+    // `funcEntries` (optional, per offset) replaces the table walk.
+    static RomTagIndex fromSites(const QByteArray& data, const QVector<int>& offsets,
+                                 const QVector<QVector<int>>* funcEntries = nullptr);
+
+    // Composing an image index: entries must be added in ascending offset
+    // order, i.e. parts in placement order with each part's seam after it.
+
+    // Append the entries of `other` shifted by `shift` bytes (part placed at
+    // offset `shift` of an image).  Structures crossing `limit` are dropped.
+    void append(const RomTagIndex& other, int shift, int limit);
+
+    // Decode the RomTags of `data` whose magic lies in [from, to) – used for
+    // the seams between composed parts, where a structure spans two parts.
+    void addRange(const QByteArray& data, int from, int to);
+
+    // Entries whose whole Resident structure lies in [from, to), shifted to
+    // be relative to `from` (the inverse of append()).  Init structs outside
+    // the range are dropped.
+    RomTagIndex section(int from, int to) const;
+
+    // Re-read entry i from `data`, e.g. after the bytes were patched.
+    void refresh(const QByteArray& data, int i);
+
+private:
+    void decodeAt(const QByteArray& data, int off);
+    void locateFuncEntries(const QByteArray& data, int i);
+};
@@ -1,45 +1,42 @@
 #include "RomTools.h"
+#include "ByteOrderView.h"
+#include "MappedFile.h"
 
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtConcurrent/QtConcurrentMap>
 #include <QtGlobal>
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 namespace RomTools {
 
 namespace {
 
-quint32 readBe32(const QByteArray& data, int offset) {
-    if (offset < 0 || offset + 4 > data.size()) return 0;
-    const auto* p = reinterpret_cast<const unsigned char*>(data.constData() + offset);
-    return (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | quint32(p[3]);
-}
-
-quint16 readBe16(const QByteArray& data, int offset) {
-    if (offset < 0 || offset + 2 > data.size()) return 0;
-    const auto* p = reinterpret_cast<const unsigned char*>(data.constData() + offset);
-    return (quint16(p[0]) << 8) | quint16(p[1]);
-}
-
 bool isPrintableAscii(unsigned char c) {
     return c >= 0x20 && c <= 0x7e;
 }
 
-QString readCStringAtAddress(const QByteArray& rom, quint32 addr, quint32 baseAddr) {
+template <ByteOrder Order>
+QString readCStringAtAddress(const ByteOrderView<Order>& rom, quint32 addr, quint32 baseAddr) {
     if (addr < baseAddr) return {};
     const int start = int(addr - baseAddr);
     if (start < 0 || start >= rom.size()) return {};
 
     QByteArray out;
     for (int i = start; i < rom.size(); ++i) {
-        const unsigned char c = static_cast<unsigned char>(rom[i]);
+        const unsigned char c = rom.at(i);
         if (c == 0) break;
         if (!isPrintableAscii(c)) return {};
         out.append(char(c));
@@ -80,13 +77,14 @@ quint32 normalizeAddress(quint32 addr, quint32 baseAddr, int romSize) {
     return 0;
 }
 
-QVector<quint32> baseCandidates(const QByteArray& rom) {
+template <ByteOrder Order>
+QVector<quint32> baseCandidates(const ByteOrderView<Order>& rom) {
     QVector<quint32> out;
     out.push_back(detectBaseAddressBySize(rom.size()));
 
     // Heuristic from initial PC vector.
     if (rom.size() >= 8) {
-        quint32 pc = readBe32(rom, 4) & 0x00FFFFFFu;
+        quint32 pc = rom.be32(4) & 0x00FFFFFFu;
         int size = rom.size();
         if (size > 0 && (size & (size - 1)) == 0) {
             quint32 mask = quint32(size - 1);
@@ -100,51 +98,107 @@ QVector<quint32> baseCandidates(const QByteArray& rom) {
     return out;
 }
 
-QVector<ComponentInfo> scanComponentsWithBase(const QByteArray& rom, quint32 baseAddr) {
-    QVector<ComponentInfo> out;
+// Resident fields of one 0x4AFC hit, decoded once and shared by all bases.
+struct RawTag {
+    int offset = 0;
+    quint32 matchTagRaw = 0;
+    quint32 endSkipRaw = 0;
+    quint32 namePtrRaw = 0;
+};
+
+// A RomTag that is plausible for one particular base address.
+struct TagHit {
+    int offset = 0;
+    quint32 endSkipRaw = 0;
+    QString name;
+};
+
+template <ByteOrder Order>
+QVector<RawTag> collectRawTags(const ByteOrderView<Order>& rom) {
+    QVector<RawTag> out;
+    const auto candidates = rom.romTagCandidates(RomKernels::TagStride::Byte, 26);
+    out.reserve(candidates.size());
+    for (const int i : candidates) {
+        RawTag t;
+        t.offset = i;
+        t.matchTagRaw = rom.be32(i + 2);
+        t.endSkipRaw = rom.be32(i + 6);
+        t.namePtrRaw = rom.be32(i + 14);
+        out.push_back(t);
+    }
+    return out;
+}
 
-    for (int i = 0; i + 26 <= rom.size(); ++i) {
-        if (readBe16(rom, i) != 0x4AFC) continue;
+// Every tag votes for the base its self-pointer implies (rt_MatchTag minus
+// its offset).  Bases that at least two tags agree on, most votes first.
+QVector<quint32> votedBases(const QVector<RawTag>& tags, int romSize) {
+    QHash<quint32, int> votes;
+    for (const auto& t : tags) {
+        const quint32 matchTag = t.matchTagRaw & 0x00FFFFFFu;
+        if (matchTag < quint32(t.offset)) continue;
+        const quint32 base = matchTag - quint32(t.offset);
+        if (quint64(base) + quint64(romSize) > 0x01000000ull) continue;
+        ++votes[base];
+    }
 
-        const quint32 matchTagRaw = readBe32(rom, i + 2);
-        const quint32 namePtrRaw = readBe32(rom, i + 14);
+    QVector<QPair<int, quint32>> ranked;
+    for (auto it = votes.cbegin(); it != votes.cend(); ++it) {
+        if (it.value() >= 2) ranked.push_back(qMakePair(it.value(), it.key()));
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const QPair<int, quint32>& a, const QPair<int, quint32>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    QVector<quint32> out;
+    for (int i = 0; i < ranked.size() && i < 4; ++i) out.push_back(ranked[i].second);
+    return out;
+}
 
-        const quint32 matchTag = normalizeAddress(matchTagRaw, baseAddr, rom.size());
-        const quint32 namePtr = normalizeAddress(namePtrRaw, baseAddr, rom.size());
+template <ByteOrder Order>
+QVector<TagHit> matchTagsForBase(const ByteOrderView<Order>& rom, const QVector<RawTag>& tags, quint32 baseAddr) {
+    QVector<TagHit> out;
+
+    for (const auto& t : tags) {
+        const quint32 matchTag = normalizeAddress(t.matchTagRaw, baseAddr, rom.size());
+        const quint32 namePtr = normalizeAddress(t.namePtrRaw, baseAddr, rom.size());
         if (!matchTag || !namePtr) continue;
 
         const int expected = int(matchTag - baseAddr);
-        if (std::abs(expected - i) > 32) continue;
+        if (std::abs(expected - t.offset) > 32) continue;
 
-        const QString name = readCStringAtAddress(rom, namePtr, baseAddr);
+        QString name = readCStringAtAddress(rom, namePtr, baseAddr);
         if (name.isEmpty()) continue;
 
-        ComponentInfo c;
-        c.name = name;
-        c.offset = i;
-        c.size = 0; // assigned after sort
-        out.push_back(std::move(c));
+        TagHit h;
+        h.offset = t.offset;
+        h.endSkipRaw = t.endSkipRaw;
+        h.name = std::move(name);
+        out.push_back(std::move(h));
     }
+    return out;
+}
 
-    std::sort(out.begin(), out.end(), [](const ComponentInfo& a, const ComponentInfo& b) {
-        return a.offset < b.offset;
-    });
+template <ByteOrder Order>
+QVector<ComponentInfo> scanComponentsWithBase(const ByteOrderView<Order>& rom, const QVector<TagHit>& hits, quint32 baseAddr) {
+    QVector<ComponentInfo> out;
+    QVector<quint32> endSkips;
 
-    // Deduplicate by offset
-    QVector<ComponentInfo> dedup;
-    for (const auto& c : out) {
-        if (!dedup.isEmpty() && dedup.back().offset == c.offset) continue;
-        dedup.push_back(c);
+    // Hits arrive in ascending offset order (one per candidate offset).
+    for (const auto& h : hits) {
+        ComponentInfo c;
+        c.name = h.name;
+        c.offset = h.offset;
+        c.size = 0; // assigned below
+        out.push_back(std::move(c));
+        endSkips.push_back(h.endSkipRaw);
     }
 
-    for (int idx = 0; idx < dedup.size(); ++idx) {
-        const int start = dedup[idx].offset;
-        const int end = (idx + 1 < dedup.size()) ? dedup[idx + 1].offset : rom.size();
-        const int nextStart = (idx + 1 < dedup.size()) ? dedup[idx + 1].offset : rom.size();
+    for (int idx = 0; idx < out.size(); ++idx) {
+        const int start = out[idx].offset;
+        const int nextStart = (idx + 1 < out.size()) ? out[idx + 1].offset : rom.size();
 
         int end = nextStart;
-        const quint32 endSkipRaw = readBe32(rom, start + 6);
-        const quint32 endSkipNorm = normalizeAddress(endSkipRaw, baseAddr, rom.size());
+        const quint32 endSkipNorm = normalizeAddress(endSkips[idx], baseAddr, rom.size());
         if (endSkipNorm) {
             const int endByTag = int(endSkipNorm - baseAddr);
             if (endByTag > start && endByTag <= rom.size()) {
@@ -152,98 +206,78 @@ QVector<ComponentInfo> scanComponentsWithBase(const QByteArray& rom, quint32 bas
             }
         }
 
-        if (end <= start) {
-            dedup[idx].size = 0;
-            dedup[idx].data.clear();
-            dedup[idx].checksumSha256.clear();
-            continue;
-        }
-        dedup[idx].size = end - start;
-        dedup[idx].data = rom.mid(start, dedup[idx].size);
-        dedup[idx].checksumSha256 = QCryptographicHash::hash(dedup[idx].data, QCryptographicHash::Sha256);
+        out[idx].size = (end > start) ? end - start : 0;
     }
 
     QVector<ComponentInfo> finalOut;
 
     // Preserve bytes before the first detected RomTag as dedicated header block.
     // Without this prelude, reassembled ROMs may miss vectors/startup header.
-    if (!dedup.isEmpty() && dedup[0].offset > 0) {
+    if (!out.isEmpty() && out[0].offset > 0) {
         ComponentInfo header;
         header.name = "__rom_header";
         header.offset = 0;
-        header.size = dedup[0].offset;
-        header.data = rom.left(header.size);
-        header.checksumSha256 = QCryptographicHash::hash(header.data, QCryptographicHash::Sha256);
+        header.size = out[0].offset;
         finalOut.push_back(std::move(header));
     }
 
-    for (auto& c : dedup) {
+    for (auto& c : out) {
         if (c.size > 0) finalOut.push_back(std::move(c));
     }
 
     return finalOut;
 }
 
-QVector<ComponentInfo> bestScan(const QByteArray& rom) {
-    QVector<ComponentInfo> best;
-    const auto bases = baseCandidates(rom);
+// One candidate pass for the whole ROM: raw tags are decoded once, every base
+// (size/PC heuristics plus what the tags themselves vote for) is scored
+// against that list, and only the winner gets its components materialized.
+// Runs on the raw bytes in either byte order and only lays out offsets and
+// sizes; attachPayloads() then slices the winning canonical buffer.
+template <ByteOrder Order>
+QVector<ComponentInfo> bestScan(const ByteOrderView<Order>& rom) {
+    const auto tags = collectRawTags(rom);
+    if (tags.isEmpty()) return {};
+
+    QVector<quint32> bases = baseCandidates(rom);
+    for (quint32 voted : votedBases(tags, rom.size())) {
+        if (!bases.contains(voted)) bases.push_back(voted);
+    }
+
+    QVector<TagHit> best;
+    quint32 bestBase = 0;
     for (quint32 base : bases) {
-        auto curr = scanComponentsWithBase(rom, base);
-        if (curr.size() > best.size()) best = std::move(curr);
+        auto curr = matchTagsForBase(rom, tags, base);
+        if (curr.size() > best.size()) {
+            best = std::move(curr);
+            bestBase = base;
+        }
     }
-    return best;
+    return scanComponentsWithBase(rom, best, bestBase);
 }
 
 
 
-bool hasValidKickChecksum(const QByteArray& rom) {
-    if (rom.size() < 4 || (rom.size() % 4) != 0) return false;
-
-    quint64 sum = 0;
-    for (int off = 0; off < rom.size(); off += 4) {
-        sum += readBe32(rom, off);
+void attachPayloads(QVector<ComponentInfo>& comps, const RomSlice& rom) {
+    for (auto& c : comps) {
+        c.data = rom.mid(c.offset, c.size);
     }
-    return (quint32(sum & 0xFFFFFFFFu) == 0xFFFFFFFFu);
 }
 
-
 int detectEffectiveKickSize(const QByteArray& image) {
-    if (image.size() == 256 * 1024) return 256 * 1024;
-    if (image.size() == 512 * 1024) {
-        const QByteArray first = image.left(256 * 1024);
-        const QByteArray second = image.mid(256 * 1024, 256 * 1024);
-        if (first == second) return 256 * 1024;
-        return 512 * 1024;
+    constexpr int half = 256 * 1024;
+    if (image.size() == half) return half;
+    if (image.size() == 2 * half) {
+        // Mirrored halves compared in place, no half-size copies.
+        if (std::memcmp(image.constData(), image.constData() + half, half) == 0) return half;
+        return 2 * half;
     }
     return 0;
 }
 
-void finalizeKickChecksum(QByteArray& image, int effectiveSize) {
-    if (effectiveSize <= 0 || effectiveSize > image.size() || (effectiveSize % 4) != 0) return;
-
-    const int checksumOff = effectiveSize - 4;
-    image[checksumOff + 0] = 0;
-    image[checksumOff + 1] = 0;
-    image[checksumOff + 2] = 0;
-    image[checksumOff + 3] = 0;
-
-    quint64 sum = 0;
-    for (int off = 0; off < effectiveSize; off += 4) {
-        sum += readBe32(image, off);
-    }
-    const quint32 partial = quint32(sum & 0xFFFFFFFFu);
-    const quint32 checksum = quint32((0x100000000ULL - partial) & 0xFFFFFFFFu);
-
-    image[checksumOff + 0] = char((checksum >> 24) & 0xff);
-    image[checksumOff + 1] = char((checksum >> 16) & 0xff);
-    image[checksumOff + 2] = char((checksum >> 8) & 0xff);
-    image[checksumOff + 3] = char(checksum & 0xff);
-}
+void separateTrailingChecksum(QVector<ComponentInfo>& comps, const RomSlice& rom, QStringList* warnings) {
+    if (comps.isEmpty() || rom.size < 4 || !hasValidKickChecksum(rom.view())) return;
 
-void separateTrailingChecksum(QVector<ComponentInfo>& comps, const QByteArray& rom, QStringList* warnings) {
-    if (comps.isEmpty() || rom.size() < 4 || !hasValidKickChecksum(rom)) return;
-
-    const int checksumOff = rom.size() - 4;
+    const int checksumOff = rom.size - 4;
 
     int ownerIdx = -1;
     for (int i = 0; i < comps.size(); ++i) {
@@ -258,19 +292,17 @@ void separateTrailingChecksum(QVector<ComponentInfo>& comps, const QByteArray& r
 
     auto& owner = comps[ownerIdx];
     const int ownerEnd = owner.offset + owner.size;
-    if (ownerEnd != rom.size() || owner.size < 4) return;
+    if (ownerEnd != rom.size || owner.size < 4) return;
 
     // Detach trailing checksum longword from containing component/trailer.
     owner.size -= 4;
     owner.data = rom.mid(owner.offset, owner.size);
-    owner.checksumSha256 = QCryptographicHash::hash(owner.data, QCryptographicHash::Sha256);
 
     ComponentInfo checksum;
     checksum.name = "__rom_checksum";
     checksum.offset = checksumOff;
     checksum.size = 4;
     checksum.data = rom.mid(checksumOff, 4);
-    checksum.checksumSha256 = QCryptographicHash::hash(checksum.data, QCryptographicHash::Sha256);
     comps.push_back(std::move(checksum));
 
     if (warnings) warnings->push_back("Separated trailing ROM checksum longword into __rom_checksum metadata component (removed from payload/trailer).");
@@ -278,15 +310,55 @@ void separateTrailingChecksum(QVector<ComponentInfo>& comps, const QByteArray& r
 
 } // namespace
 
+bool hasValidKickChecksum(const QByteArray& image, int effectiveSize, RomKernels::ChecksumMode mode) {
+    if (effectiveSize < 0) effectiveSize = image.size();
+    if (effectiveSize < 4 || effectiveSize > image.size() || (effectiveSize % 4) != 0) return false;
+    return RomKernels::reduceSum(RomKernels::sumBe32(image.constData(), effectiveSize), mode) == 0xFFFFFFFFu;
+}
+
+void finalizeKickChecksum(QByteArray& image, int effectiveSize, RomKernels::ChecksumMode mode) {
+    if (effectiveSize <= 0 || effectiveSize > image.size() || (effectiveSize % 4) != 0) return;
+    finalizeKickChecksum(image.data(), effectiveSize, mode);
+}
+
+void finalizeKickChecksum(char* image, int effectiveSize, RomKernels::ChecksumMode mode) {
+    if (!image || effectiveSize <= 0 || (effectiveSize % 4) != 0) return;
+    finalizeKickChecksumFromSum(image, effectiveSize, RomKernels::sumBe32(image, effectiveSize), mode);
+}
+
+void finalizeKickChecksumFromSum(QByteArray& image, int effectiveSize, quint64 rawSum,
+                                 RomKernels::ChecksumMode mode) {
+    if (effectiveSize <= 0 || effectiveSize > image.size() || (effectiveSize % 4) != 0) return;
+    finalizeKickChecksumFromSum(image.data(), effectiveSize, rawSum, mode);
+}
+
+void finalizeKickChecksumFromSum(char* image, int effectiveSize, quint64 rawSum,
+                                 RomKernels::ChecksumMode mode) {
+    if (!image || effectiveSize <= 0 || (effectiveSize % 4) != 0) return;
+
+    // Henne-Ei safe: the checksum slot counts as 0 during summation, then gets
+    // the complement so the sum over the effective image becomes 0xFFFFFFFF.
+    auto* slot = reinterpret_cast<unsigned char*>(image + effectiveSize - 4);
+    rawSum -= (quint32(slot[0]) << 24) | (quint32(slot[1]) << 16) | (quint32(slot[2]) << 8) | quint32(slot[3]);
+    const quint32 checksum = ~RomKernels::reduceSum(rawSum, mode);
+
+    slot[0] = static_cast<unsigned char>((checksum >> 24) & 0xff);
+    slot[1] = static_cast<unsigned char>((checksum >> 16) & 0xff);
+    slot[2] = static_cast<unsigned char>((checksum >> 8) & 0xff);
+    slot[3] = static_cast<unsigned char>(checksum & 0xff);
+}
+
 QByteArray swap16(const QByteArray& in) {
-    QByteArray out = in;
-    if (out.size() % 2) out.append(char(0xff));
-    for (int i = 0; i + 1 < out.size(); i += 2) {
-        std::swap(out[i], out[i + 1]);
-    }
+    QByteArray out((in.size() + 1) & ~qsizetype(1), Qt::Uninitialized);
+    RomKernels::swap16Copy(in.constData(), in.size(), out.data());
     return out;
 }
 
+void swap16InPlace(QByteArray& data) {
+    if (data.size() % 2) data.append(char(0xff));
+    RomKernels::swap16InPlace(data.data(), data.size());
+}
+
 QByteArray toHex(const QByteArray& bytes) {
     return bytes.toHex();
 }
@@ -298,14 +370,14 @@ RomMeta inspectRom(const QString& path) {
     QFileInfo fi(path);
     meta.fileName = fi.fileName();
 
-    QFile f(path);
-    if (!f.open(QIODevice::ReadOnly)) {
+    // Map instead of readAll(): detection reads the file in place, and the
+    // only copy made is the canonical (possibly swapped) one that is kept.
+    const MappedFile file(path);
+    if (!file.isOpen()) {
         meta.warnings << "Failed to open file.";
         return meta;
     }
-
-    QByteArray raw = f.readAll();
-    f.close();
+    const QByteArray raw = file.bytes();
 
     meta.originalSize = raw.size();
     meta.validSize = (raw.size() > 0 && raw.size() <= TOTAL_BYTES);
@@ -316,54 +388,38 @@ RomMeta inspectRom(const QString& path) {
 
     // Determine byte order: .rom files are historically byte-swapped.
     // But verify with content: look for 0x4AFC (RomTag) or 0x1111 0x4EF9
-    // (Kickstart header) to auto-detect the actual byte order.
+    // (Kickstart header) to auto-detect the actual byte order.  Both checks
+    // read the raw bytes in place; only the final canonical copy is swapped.
     meta.alreadyByteswapped = fi.suffix().compare("rom", Qt::CaseInsensitive) == 0;
-    {
-        auto hasSignatures = [](const QByteArray& d) -> bool {
-            if (d.size() < 4) return false;
-            const auto rd16 = [&](int off) -> quint16 {
-                const auto* p = reinterpret_cast<const unsigned char*>(d.constData() + off);
-                return (quint16(p[0]) << 8) | quint16(p[1]);
-            };
-            if (rd16(0) == 0x4AFC) return true;
-            if (rd16(0) == 0x1111 && rd16(2) == 0x4EF9) return true;
-            if (rd16(0) == 0x4EF9) return true;
-            // Scan first 256 bytes for RomTag magic.
-            for (int off = 2; off + 2 <= qMin(d.size(), 256); off += 2)
-                if (rd16(off) == 0x4AFC) return true;
-            return false;
-        };
-        if (hasSignatures(raw)) {
-            meta.alreadyByteswapped = false;   // raw is canonical
-        } else if (hasSignatures(swap16(raw))) {
-            meta.alreadyByteswapped = true;    // raw is byte-swapped
-        }
-        // else: keep extension-based heuristic
-    }
-    meta.alreadyByteswapped = fi.suffix().compare("rom", Qt::CaseInsensitive) == 0;
-    meta.canonicalData = meta.alreadyByteswapped ? swap16(raw) : raw;
-
-    if (meta.canonicalData.size() < SLOT_SIZE) {
+    if (hasRomSignatures(CanonicalView(raw))) {
+        meta.alreadyByteswapped = false;   // raw is canonical
+    } else if (hasRomSignatures(WordSwappedView(raw))) {
+        meta.alreadyByteswapped = true;    // raw is byte-swapped
+    }
+    // else: keep extension-based heuristic
+    // The only copy of the file: canonical bytes plus 0xFF padding to 2 MiB,
+    // in one buffer that canonicalData, padded2MiB, banks and components share.
+    meta.image = RomImage::fromRaw(raw.constData(), raw.size(),
+                                   meta.alreadyByteswapped ? ByteOrder::WordSwapped : ByteOrder::Canonical,
+                                   TOTAL_BYTES);
+    meta.canonicalData = meta.image.canonical();
+    meta.padded2MiB = meta.image.slice(0, TOTAL_BYTES);
+
+    if (meta.canonicalData.size < SLOT_SIZE) {
         meta.warnings << QString("Input smaller than 512 KiB (%1 bytes), padded with 0xFF.")
-                             .arg(meta.canonicalData.size());
+                             .arg(meta.canonicalData.size);
     }
-    if (meta.canonicalData.size() < TOTAL_BYTES) {
+    if (meta.canonicalData.size < TOTAL_BYTES) {
         meta.warnings << QString("Input smaller than 2 MiB (%1 bytes), padded with 0xFF to 2 MiB for bank handling.")
-                             .arg(meta.canonicalData.size());
+                             .arg(meta.canonicalData.size);
     }
 
-    meta.padded2MiB = meta.canonicalData.left(TOTAL_BYTES);
-    if (meta.padded2MiB.size() < TOTAL_BYTES) {
-        meta.padded2MiB.append(QByteArray(TOTAL_BYTES - meta.padded2MiB.size(), char(0xff)));
-    }
-
-    meta.checksumSha256 = QCryptographicHash::hash(meta.padded2MiB, QCryptographicHash::Sha256);
     return meta;
 }
 
-QVector<SliceInfo> splitIntoBanks(const QByteArray& twoMiB) {
+QVector<SliceInfo> splitIntoBanks(const RomSlice& twoMiB) {
     QVector<SliceInfo> out;
-    if (twoMiB.size() < TOTAL_BYTES) return out;
+    if (twoMiB.size < TOTAL_BYTES) return out;
 
     for (int bank = 0; bank < 4; ++bank) {
         const int offset = bank * SLOT_SIZE;
@@ -371,36 +427,32 @@ QVector<SliceInfo> splitIntoBanks(const QByteArray& twoMiB) {
         s.bank = bank;
         s.fileName = QString("bank_%1.bin").arg(bank);
         s.data = twoMiB.mid(offset, SLOT_SIZE);
-        s.checksumSha256 = QCryptographicHash::hash(s.data, QCryptographicHash::Sha256);
         out.push_back(std::move(s));
     }
     return out;
 }
 
-QVector<ComponentInfo> extractComponents(const QByteArray& canonicalRom, QStringList* warnings) {
+QVector<ComponentInfo> extractComponents(const RomSlice& canonicalRom, QStringList* warnings) {
     QVector<ComponentInfo> out;
     if (canonicalRom.isEmpty()) return out;
 
-    out = bestScan(canonicalRom);
+    out = bestScan(CanonicalView(canonicalRom.constData(), canonicalRom.size));
+    RomSlice scanned = canonicalRom;
 
     // Fallback: if input endian assumption is wrong, scanning swapped view may recover components.
+    // The swapped view reads canonicalRom in place; a swapped copy is only made on a match.
     if (out.isEmpty()) {
-        const QByteArray swapped = swap16(canonicalRom);
+        const WordSwappedView swapped(canonicalRom.constData(), canonicalRom.size);
         auto fallback = bestScan(swapped);
         if (!fallback.isEmpty()) {
             if (warnings) warnings->push_back("RomTag scan only matched after word-swap fallback.");
 
             // The swap-fallback means canonicalRom was actually byte-swapped;
-            // `swapped` is the true canonical (big-endian) data.  Extract
-            // component payloads from the correct byte order.
-            for (auto& c : fallback) {
-                c.data = swapped.mid(c.offset, c.size);
-            // Important: always export canonical byte order component payloads.
-            for (auto& c : fallback) {
-                c.data = canonicalRom.mid(c.offset, c.size);
-                c.checksumSha256 = QCryptographicHash::hash(c.data, QCryptographicHash::Sha256);
-            }
+            // the swapped view is the true canonical (big-endian) data, so
+            // the payloads are sliced from one materialized copy of it.
             out = std::move(fallback);
+            const QByteArray canonical = swapped.materialize();
+            scanned = RomSlice(canonical, 0, int(canonical.size()));
         }
     }
 
@@ -409,12 +461,36 @@ QVector<ComponentInfo> extractComponents(const QByteArray& canonicalRom, QString
     }
 
     if (!out.isEmpty()) {
-        separateTrailingChecksum(out, canonicalRom, warnings);
+        attachPayloads(out, scanned);
+        separateTrailingChecksum(out, scanned, warnings);
+
+        // Relocation sites for the catalog: one index over the whole ROM,
+        // split per component.
+        const RomTagIndex romTags = RomTagIndex::build(scanned.view());
+        for (auto& c : out) c.tags = romTags.section(c.offset, c.offset + c.size);
     }
 
     return out;
 }
 
+void computeDigests(RomMeta& meta, QVector<SliceInfo>& slices, QVector<ComponentInfo>& components) {
+    // Every digest of an import is independent: collect them all and hash
+    // them in one fork/join stage on the global thread pool.
+    struct Job {
+        RomSlice data;
+        QByteArray* out;
+    };
+    QVector<Job> jobs;
+    jobs.reserve(1 + slices.size() + components.size());
+    jobs.push_back({meta.padded2MiB, &meta.checksumSha256});
+    for (auto& s : slices) jobs.push_back({s.data, &s.checksumSha256});
+    for (auto& c : components) jobs.push_back({c.data, &c.checksumSha256});
+
+    QtConcurrent::blockingMap(jobs, [](Job& job) {
+        *job.out = QCryptographicHash::hash(job.data.view(), QCryptographicHash::Sha256);
+    });
+}
+
 bool writeCatalog(const QString& outDir,
                   const RomMeta& meta,
                   const QVector<SliceInfo>& slices,
@@ -431,7 +507,7 @@ bool writeCatalog(const QString& outDir,
         if (error) *error = "Could not write rom_2mib.bin.";
         return false;
     }
-    full.write(meta.padded2MiB);
+    full.write(meta.padded2MiB.view());
     full.close();
 
     for (const auto& s : slices) {
@@ -440,7 +516,7 @@ bool writeCatalog(const QString& outDir,
             if (error) *error = QString("Could not write %1.").arg(s.fileName);
             return false;
         }
-        sliceFile.write(s.data);
+        sliceFile.write(s.data.view());
         sliceFile.close();
     }
 
@@ -459,7 +535,7 @@ bool writeCatalog(const QString& outDir,
             if (error) *error = QString("Could not write component file %1.").arg(fileName);
             return false;
         }
-        compFile.write(c.data);
+        compFile.write(c.data.view());
         compFile.close();
 
         QJsonObject cj;
@@ -468,14 +544,29 @@ bool writeCatalog(const QString& outDir,
         cj["size"] = c.size;
         cj["file"] = QString("components/%1").arg(fileName);
         cj["sha256"] = QString::fromLatin1(toHex(c.checksumSha256));
+
+        QJsonArray tagsJson;
+        for (int t = 0; t < c.tags.size(); ++t) {
+            QJsonObject tj;
+            tj["offset"] = c.tags.offset[t];
+            tj["flags"] = int(c.tags.flags[t]);
+            tj["pri"] = int(c.tags.pri[t]);
+            if (c.tags.initStruct[t] >= 0) tj["initStruct"] = c.tags.initStruct[t];
+            QJsonArray entries;
+            for (const int e : c.tags.funcEntries[t]) entries.append(e);
+            if (!entries.isEmpty()) tj["funcTableEntries"] = entries;
+            tagsJson.append(tj);
+        }
+        cj["romTags"] = tagsJson;
         componentsJson.append(cj);
     }
 
     QJsonObject root;
+    root["schemaVersion"] = CATALOG_SCHEMA_VERSION;
     root["sourcePath"] = meta.sourcePath;
     root["sourceFileName"] = meta.fileName;
     root["originalSize"] = static_cast<qint64>(meta.originalSize);
-    root["canonicalSize"] = meta.canonicalData.size();
+    root["canonicalSize"] = meta.canonicalData.size;
     root["isRomByteSwappedInput"] = meta.alreadyByteswapped;
     root["sha256_2mib"] = QString::fromLatin1(toHex(meta.checksumSha256));
 
@@ -488,7 +579,7 @@ bool writeCatalog(const QString& outDir,
         QJsonObject b;
         b["bank"] = s.bank;
         b["file"] = s.fileName;
-        b["size"] = s.data.size();
+        b["size"] = s.data.size;
         b["sha256"] = QString::fromLatin1(toHex(s.checksumSha256));
         banks.append(b);
     }
@@ -507,6 +598,75 @@ bool writeCatalog(const QString& outDir,
 }
 
 
+bool catalogRomTags(const QString& componentPath, const QByteArray& data, const QByteArray& sha256,
+                    RomTagIndex* tags) {
+    if (!tags) return false;
+    const QFileInfo fi(componentPath);
+    QDir catalogDir = fi.absoluteDir();
+    if (catalogDir.dirName() != "components" || !catalogDir.cdUp()) return false;
+    const QString catalogPath = catalogDir.filePath("catalog.json");
+    const QFileInfo ci(catalogPath);
+    if (!ci.isFile()) return false;
+
+    // Adding a whole components/ folder asks once per file: keep the parsed
+    // component list of the last catalog until it changes on disk.  Part
+    // reloads ask from worker threads, hence the lock.
+    static QMutex cacheMutex;
+    QMutexLocker lock(&cacheMutex);
+    static QString cachedPath;
+    static QDateTime cachedStamp;
+    static QHash<QString, QJsonObject> cachedComponents;
+    if (cachedPath != catalogPath || cachedStamp != ci.lastModified()) {
+        // Remembered only once parsed: a read during a rewrite retries next time.
+        cachedPath.clear();
+        cachedComponents.clear();
+
+        const QDateTime stamp = ci.lastModified();
+        QFile catalogFile(catalogPath);
+        if (!catalogFile.open(QIODevice::ReadOnly)) return false;
+        QJsonParseError parseError;
+        const auto doc = QJsonDocument::fromJson(catalogFile.readAll(), &parseError);
+        if (parseError.error != QJsonParseError::NoError) return false;
+        const QJsonObject root = doc.object();
+        if (root.value("schemaVersion").toInt() < 2) return false;
+        for (const auto& v : root.value("components").toArray()) {
+            const QJsonObject c = v.toObject();
+            cachedComponents.insert(c.value("file").toString(), c);
+        }
+        cachedPath = catalogPath;
+        cachedStamp = stamp;
+    }
+
+    const auto it = cachedComponents.constFind(QString("components/%1").arg(fi.fileName()));
+    if (it == cachedComponents.constEnd()) return false;
+    const QJsonObject c = it.value();
+    if (c.value("size").toInt() != data.size() || !c.value("romTags").isArray()) return false;
+    // The bytes must still be the ones the catalog describes: a rebuilt
+    // component of the same size would get stale relocation sites.
+    if (c.value("sha256").toString().toLatin1() != toHex(sha256)) return false;
+
+    QVector<int> offsets;
+    QVector<QVector<int>> funcEntries;
+    QVector<int> flags, pris;
+    for (const auto& v : c.value("romTags").toArray()) {
+        const QJsonObject tj = v.toObject();
+        offsets.push_back(tj.value("offset").toInt(-1));
+        flags.push_back(tj.value("flags").toInt());
+        pris.push_back(tj.value("pri").toInt());
+        QVector<int> entries;
+        for (const auto& e : tj.value("funcTableEntries").toArray()) entries.push_back(e.toInt());
+        funcEntries.push_back(std::move(entries));
+    }
+
+    RomTagIndex idx = RomTagIndex::fromSites(data, offsets, &funcEntries);
+    if (idx.size() != offsets.size()) return false;
+    for (int t = 0; t < idx.size(); ++t) {
+        if (int(idx.flags[t]) != flags[t] || int(idx.pri[t]) != pris[t]) return false;
+    }
+    *tags = std::move(idx);
+    return true;
+}
+
 bool rebuildFromCatalog(const QString& catalogPath,
                         QByteArray* outCanonicalRom,
                         QStringList* warnings,
@@ -551,18 +711,17 @@ bool rebuildFromCatalog(const QString& catalogPath,
         if (name == "__rom_checksum") continue; // derived field
         if (rel.isEmpty() || offset < 0 || size <= 0) continue;
 
-        QFile f(baseDir.filePath(rel));
-        if (!f.open(QIODevice::ReadOnly)) {
+        const MappedFile data(baseDir.filePath(rel));
+        if (!data.isOpen()) {
             if (warnings) warnings->push_back(QString("Missing component file: %1").arg(rel));
             continue;
         }
-        const QByteArray data = f.readAll();
-        const int writeLen = qMin(size, data.size());
+        const int writeLen = qMin(size, int(data.size()));
         if (offset + writeLen > image.size()) {
             if (warnings) warnings->push_back(QString("Component out of range skipped: %1").arg(name));
             continue;
         }
-        std::copy_n(data.constData(), writeLen, image.data() + offset);
+        std::copy_n(data.data(), writeLen, image.data() + offset);
     }
 
     // Recompute checksum using effective Kickstart size semantics:
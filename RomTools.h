@@ -5,17 +5,24 @@
 #include <QStringList>
 #include <QVector>
 
+#include "RomImage.h"
+#include "RomKernels.h"
+#include "RomTagIndex.h"
+
 namespace RomTools {
 
 static constexpr int SLOT_SIZE = 512 * 1024;
 static constexpr int TOTAL_BYTES = 4 * SLOT_SIZE;
+// catalog.json layout: 2 adds per-component RomTag relocation sites.
+static constexpr int CATALOG_SCHEMA_VERSION = 2;
 
 struct RomMeta {
     QString sourcePath;
     QString fileName;
     qint64 originalSize = 0;
-    QByteArray canonicalData;
-    QByteArray padded2MiB;
+    RomImage image;            // the one buffer; everything below points into it
+    RomSlice canonicalData;
+    RomSlice padded2MiB;
     QByteArray checksumSha256;
     bool validSize = false;
     bool alreadyByteswapped = false;
@@ -25,7 +32,7 @@ struct RomMeta {
 struct SliceInfo {
     int bank = 0;
     QString fileName;
-    QByteArray data;
+    RomSlice data;
     QByteArray checksumSha256;
 };
 
@@ -33,21 +40,52 @@ struct ComponentInfo {
     QString name;
     int offset = 0;
     int size = 0;
-    QByteArray data;
+    RomSlice data;
+    RomTagIndex tags;   // relocation sites, component-relative
     QByteArray checksumSha256;
 };
 
+// Kickstart checksum over the first `effectiveSize` bytes (-1 = whole image).
+// The default CarryFold mode matches what exec.library verifies at boot.
+bool hasValidKickChecksum(const QByteArray& image, int effectiveSize = -1,
+                          RomKernels::ChecksumMode mode = RomKernels::ChecksumMode::CarryFold);
+void finalizeKickChecksum(QByteArray& image, int effectiveSize,
+                          RomKernels::ChecksumMode mode = RomKernels::ChecksumMode::CarryFold);
+// Same, but with the raw longword sum of the current image (checksum slot
+// included) already known, e.g. maintained incrementally from part sums.
+void finalizeKickChecksumFromSum(QByteArray& image, int effectiveSize, quint64 rawSum,
+                                 RomKernels::ChecksumMode mode = RomKernels::ChecksumMode::CarryFold);
+// In-place variants for images composed into a raw window (caller owns the
+// `effectiveSize` bytes at `image`).
+void finalizeKickChecksum(char* image, int effectiveSize,
+                          RomKernels::ChecksumMode mode = RomKernels::ChecksumMode::CarryFold);
+void finalizeKickChecksumFromSum(char* image, int effectiveSize, quint64 rawSum,
+                                 RomKernels::ChecksumMode mode = RomKernels::ChecksumMode::CarryFold);
+
+// Word swap; odd-sized input is padded with 0xFF to an even size first.
 QByteArray swap16(const QByteArray& in);
+void swap16InPlace(QByteArray& data);
 QByteArray toHex(const QByteArray& bytes);
 RomMeta inspectRom(const QString& path);
-QVector<SliceInfo> splitIntoBanks(const QByteArray& twoMiB);
-QVector<ComponentInfo> extractComponents(const QByteArray& canonicalRom, QStringList* warnings = nullptr);
+QVector<SliceInfo> splitIntoBanks(const RomSlice& twoMiB);
+QVector<ComponentInfo> extractComponents(const RomSlice& canonicalRom, QStringList* warnings = nullptr);
+// SHA-256 of the padded image, every bank and every component, computed in
+// parallel.  inspectRom/splitIntoBanks/extractComponents leave them empty.
+void computeDigests(RomMeta& meta, QVector<SliceInfo>& slices, QVector<ComponentInfo>& components);
 bool writeCatalog(const QString& outDir,
                   const RomMeta& meta,
                   const QVector<SliceInfo>& slices,
                   const QVector<ComponentInfo>& components,
                   QString* error);
 
+// Relocation sites of a component file as recorded in the catalog.json of
+// its extraction (schemaVersion >= 2, file under components/).  Decodes the
+// recorded RomTags of `data` without scanning; false when there is no usable
+// record or the component's recorded SHA-256 is not `sha256` (digest of
+// `data`), so the caller scans instead.
+bool catalogRomTags(const QString& componentPath, const QByteArray& data, const QByteArray& sha256,
+                    RomTagIndex* tags);
+
 bool rebuildFromCatalog(const QString& catalogPath,
                         QByteArray* outCanonicalRom,
                         QStringList* warnings,